@@ -0,0 +1,36 @@
+#include "addondata.h"
+
+thread_local AddonData *AddonData::current = 0;
+
+void AddonData::Init()
+{
+  AddonData *data = new AddonData();
+  current = data;
+  node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(), Cleanup, data);
+}
+
+// before the isolate is disposed, on its thread
+void AddonData::Cleanup(void *arg)
+{
+  AddonData *data = (AddonData *)arg;
+  if (current == data) {
+    current = 0;
+  }
+  delete data;
+}
+
+AddonData::~AddonData()
+{
+  uint64Tmpl.Reset();
+  int64Tmpl.Reset();
+  uint64Constructor.Reset();
+  int64Constructor.Reset();
+  bloomFilterTmpl.Reset();
+  histogramTmpl.Reset();
+  histogramConstructor.Reset();
+  textParserTmpl.Reset();
+  mappedFileTmpl.Reset();
+  modulusTmpl.Reset();
+  recordSchemaTmpl.Reset();
+  fixedPointTmpl.Reset();
+}
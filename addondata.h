@@ -0,0 +1,38 @@
+#ifndef _ADDONDATA_H
+#define _ADDONDATA_H
+
+#include <nan.h>
+
+/* Provides: per-isolate state of the addon (templates and constructors of the wrapped classes)
+
+The main thread and every worker_threads Worker load the addon into their own isolate, on their own
+thread; v8 handles are only valid in the isolate that created them.
+
+AddonData::Init()  - at module init, for the current isolate; freed by an environment cleanup hook
+AddonData::Get()   - state of the calling thread's isolate
+*/
+
+struct AddonData {
+  Nan::Persistent<v8::FunctionTemplate> uint64Tmpl, int64Tmpl;
+  Nan::Persistent<v8::Function> uint64Constructor, int64Constructor;
+  Nan::Persistent<v8::FunctionTemplate> bloomFilterTmpl;
+  Nan::Persistent<v8::FunctionTemplate> histogramTmpl;
+  Nan::Persistent<v8::Function> histogramConstructor;
+  Nan::Persistent<v8::FunctionTemplate> textParserTmpl;
+  Nan::Persistent<v8::FunctionTemplate> mappedFileTmpl;
+  Nan::Persistent<v8::FunctionTemplate> modulusTmpl;
+  Nan::Persistent<v8::FunctionTemplate> recordSchemaTmpl;
+  Nan::Persistent<v8::FunctionTemplate> fixedPointTmpl;
+
+  static void Init();
+  static AddonData *Get() { return current; }
+
+private:
+  AddonData() {}
+  ~AddonData();
+
+  static void Cleanup(void *arg);
+  static thread_local AddonData *current;
+};
+
+#endif
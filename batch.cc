@@ -0,0 +1,84 @@
+#include "batch.h"
+#include "uint64.h"
+#include "column.h"
+#include "kernels.h"
+#include "ext/bitops.h"
+
+// name, BITOP_*
+#define BATCH_UNARY_OPS \
+  X(popcnt,     BITOP_POPCNT)     \
+  X(parity,     BITOP_PARITY)     \
+  X(bswap,      BITOP_BSWAP)      \
+  X(bitReverse, BITOP_BITREVERSE) \
+  X(blsr,       BITOP_BLSR)       \
+  X(blsi,       BITOP_BLSI)
+
+#define BATCH_MASK_OPS \
+  X(pdep,       BITOP_PDEP)       \
+  X(pext,       BITOP_PEXT)
+
+#define X(name,op) \
+  static NAN_METHOD(name ## Batch)                                  \
+  {                                                                 \
+    U64Column src, dst;                                             \
+    if ( (U64Column::FromArgument(info[0],src))&&                   \
+         (U64Column::DstArgument(info,1,src,dst)) ) {               \
+      u64k->bitop_batch(op, dst.data, src.data, src.length, 0, 0, 0); \
+      info.GetReturnValue().Set((info[1]->IsUndefined()) ? info[0] : info[1]); \
+    }                                                               \
+  }
+BATCH_UNARY_OPS
+#undef X
+
+#define X(name,op) \
+  static NAN_METHOD(name ## Batch)                                  \
+  {                                                                 \
+    U64Column src, dst;                                             \
+    uint64_t mask;                                                  \
+    if ( (U64Column::FromArgument(info[0],src))&&                   \
+         (UInt64::FromArgument(info[1],mask))&&                     \
+         (U64Column::DstArgument(info,2,src,dst)) ) {               \
+      u64k->bitop_batch(op, dst.data, src.data, src.length, mask, 0, 0); \
+      info.GetReturnValue().Set((info[2]->IsUndefined()) ? info[0] : info[2]); \
+    }                                                               \
+  }
+BATCH_MASK_OPS
+#undef X
+
+static NAN_METHOD(extractBitsBatch)
+{
+  U64Column src, dst;
+  unsigned int start, len;
+  if ( (U64Column::FromArgument(info[0],src))&&
+       (UInt64::BitRangeArguments(info,1,start,len))&&
+       (U64Column::DstArgument(info,3,src,dst)) ) {
+    u64k->bitop_batch(BITOP_EXTRACT, dst.data, src.data, src.length, 0, start, len);
+    info.GetReturnValue().Set((info[3]->IsUndefined()) ? info[0] : info[3]);
+  }
+}
+
+static NAN_METHOD(insertBitsBatch)
+{
+  U64Column dst, bits;
+  unsigned int start, len;
+  if ( (!U64Column::FromArgument(info[0],dst))||
+       (!U64Column::FromArgument(info[1],bits))||
+       (!UInt64::BitRangeArguments(info,2,start,len)) ) {
+    return;
+  } else if (dst.length < bits.length) {
+    Nan::ThrowRangeError("Destination column too short");
+    return;
+  }
+  u64k->bitop_batch(BITOP_INSERT, dst.data, bits.data, bits.length, 0, start, len);
+  info.GetReturnValue().Set(info[0]);
+}
+
+NAN_MODULE_INIT(InitBatch)
+{
+#define X(name,op) Nan::SetMethod(target, #name "Batch", name ## Batch);
+  BATCH_UNARY_OPS
+  BATCH_MASK_OPS
+#undef X
+  Nan::SetMethod(target, "extractBitsBatch", extractBitsBatch);
+  Nan::SetMethod(target, "insertBitsBatch", insertBitsBatch);
+}
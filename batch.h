@@ -0,0 +1,24 @@
+#ifndef _BATCH_H
+#define _BATCH_H
+
+#include <nan.h>
+
+/* Provides: column-wide kernels on packed u64 columns (cf. column.h)
+  dst defaults to src (i.e. in-place), dst.length must be >= src.length; all return dst
+
+u64.popcntBatch(src[,dst])
+u64.parityBatch(src[,dst])
+u64.bswapBatch(src[,dst])
+u64.bitReverseBatch(src[,dst])
+u64.blsrBatch(src[,dst])
+u64.blsiBatch(src[,dst])
+u64.pdepBatch(src,mask[,dst])
+u64.pextBatch(src,mask[,dst])
+u64.extractBitsBatch(src,start,len[,dst])
+u64.insertBitsBatch(dst,bits,start,len)    - dst[i] = dst[i].insertBits(bits[i],start,len)
+* start, len: integers 0..64, as for UInt64 extractBits/insertBits
+*/
+
+NAN_MODULE_INIT(InitBatch);
+
+#endif
@@ -0,0 +1,222 @@
+// Benchmarks every native entry point (+ bench/u64bench, if built: make -C bench)
+// usage: node bench/run.js [--filter substr] [--out results.json] [--compare baseline.json] [--threshold percent]
+//   --compare exits with 1, if any benchmark got slower than threshold (default: 10%)
+
+var fs=require('fs'),
+    path=require('path'),
+    child_process=require('child_process');
+var u64=require('..');
+var UInt64=u64.UInt64,
+    Int64=u64.Int64;
+
+var opts={filter:null, out:null, compare:null, threshold:10};
+for (var i=2; i<process.argv.length; i++) {
+  var m=/^--(\w+)$/.exec(process.argv[i]);
+  if (!m || !(m[1] in opts) || i+1>=process.argv.length) {
+    console.error('Usage: node bench/run.js [--filter substr] [--out results.json] [--compare baseline.json] [--threshold percent]');
+    process.exit(2);
+  }
+  opts[m[1]]=process.argv[++i];
+}
+
+var results=[];
+
+function now() {
+  var t=process.hrtime();
+  return t[0]*1e9+t[1];
+}
+
+// fn(n) must perform the operation n*opsPerCall times; reports best of 5 runs of >=20ms
+function bench(name,fn,opsPerCall) {
+  if (opts.filter && name.indexOf(opts.filter)<0) {
+    return;
+  }
+  opsPerCall=opsPerCall || 1;
+  var n=1, start;
+  for (;;) {
+    start=now();
+    fn(n);
+    if (now()-start>20e6) {
+      break;
+    }
+    n*=2;
+  }
+  var best=Infinity;
+  for (var run=0; run<5; run++) {
+    start=now();
+    fn(n);
+    best=Math.min(best,(now()-start)/(n*opsPerCall));
+  }
+  results.push({name:'js/'+name, ns:best, iterations:n*opsPerCall});
+}
+
+// monomorphic loop per benchmark: `body` may use a, b, c, i, u64, UInt64, Int64 and assign to ret
+function loop(body,a,b,c) {
+  var fn=new Function('u64','UInt64','Int64','a','b','c','n',
+                      'var ret; for (var i=0; i<n; i++) { '+body+'; } return ret;');
+  return function(n) {
+    return fn(u64,UInt64,Int64,a,b,c,n);
+  };
+}
+
+// X(name...) entries of the UINT64_*_OPS lists in uint64.h
+function opLists() {
+  var src=fs.readFileSync(path.join(__dirname,'..','uint64.h'),'utf8');
+  var ret={}, re=/^#define (UINT64_\w+_OPS)((?:.*\\\n)*.*)$/gm, m;
+  while ((m=re.exec(src))) {
+    var names=[], xre=/X\((\w+),\s*(\w+)?/g, x;
+    while ((x=xre.exec(m[2]))) {
+      names.push(/COPY/.test(m[1]) ? [x[1],x[2]] : x[1]);
+    }
+    ret[m[1]]=names;
+  }
+  return ret;
+}
+
+// additional arguments, beyond the first (rhs)
+var extraArgs={add2:', true', sub2:', true', insertBits:', 8, 16', extractBits:', 16'};
+
+function benchOps() {
+  var lists=opLists(), a=new UInt64('0x123456789abcdef0'), b=new UInt64('0x0fedcba987654321'), out=new UInt64();
+  Object.keys(lists).forEach(function(list) {
+    lists[list].forEach(function(op) {
+      if (/COPY/.test(list)) { // [name, copyName]; c is the destination
+        var rhs=/UNARY/.test(list) ? '' : /UINT/.test(list) ? '3, ' : 'b, ';
+        bench('copy/'+op[1], loop('ret = a.'+op[1]+'('+rhs.replace(/, $/,'')+')',a,b,out));
+        bench('copy/'+op[1]+'+out', loop('a.'+op[1]+'('+rhs+'c)',a,b,out));
+        bench('static/'+op[0]+'+out', loop('UInt64.'+op[0]+'(a, '+rhs+'c)',a,b,out));
+        return;
+      }
+      var extra=extraArgs[op] || '';
+      if (/UNARY/.test(list)) {
+        bench('op/'+op, loop('a.'+op+'()',a.clone(),b));
+      } else if (/BINARY/.test(list)) {
+        bench('op/'+op, loop('a.'+op+'(b'+extra+')',a.clone(),b));
+      } else {
+        bench('op/'+op, loop('a.'+op+'(3'+extra+')',a.clone(),b));
+      }
+    });
+  });
+}
+
+function benchConstructors() {
+  // UInt64::New: construct call vs. plain call (-> NewInstance)
+  bench('new/construct/0', loop('ret = new UInt64()'));
+  bench('new/construct/number', loop('ret = new UInt64(12345)'));
+  bench('new/construct/hi-lo', loop('ret = new UInt64(0x12345678, 0x9abcdef0)'));
+  bench('new/construct/Int64', loop('ret = new Int64(-12345)'));
+  bench('new/call/number', loop('ret = UInt64(12345)'));
+  bench('new/call/Int64', loop('ret = Int64(-12345)'));
+  bench('clone', loop('ret = a.clone()',new UInt64(7)));
+
+  // UInt64::FromArgument, per argument type
+  var a=new UInt64(12345), args={
+    'Number': 12345,
+    'String/dec': '12345678901234567890',
+    'String/hex': '0x123456789abcdef0',
+    'UInt64': new UInt64(12345)
+  };
+  if (typeof BigInt==='function') {
+    args.BigInt=BigInt('12345678901234567890');
+  }
+  Object.keys(args).forEach(function(type) {
+    bench('FromArgument/'+type, loop('a.eq(b)',a,args[type]));
+  });
+}
+
+function benchStrings() {
+  var a=new UInt64('0xfedcba9876543210'), s=new Int64('-1234567890123456789');
+  [2,8,10,16,36].forEach(function(radix) {
+    bench('toString/radix'+radix, loop('ret = a.toString(b)',a,radix));
+  });
+  bench('toSignedString/radix10', loop('ret = a.toSignedString(10)',s));
+}
+
+function benchDoubles() {
+  var mantissa=new UInt64('0x0018000000000000');
+  bench('buildDouble', loop('ret = b.buildDouble(1, a, 10)',mantissa,u64));
+  bench('splitDouble', loop('ret = b.splitDouble(1234.5678 + i)',null,u64));
+
+  // grabDouble mutates: reload the value every iteration
+  bench('grabDouble/UInt64/precise', loop('a.hi32 = 0x001fffff; a.lo32 = i; ret = a.grabDouble()',new UInt64()));
+  bench('grabDouble/UInt64/rounded', loop('a.hi32 = 0xfedcba98; a.lo32 = i; ret = a.grabDouble(1)',new UInt64()));
+  bench('grabDouble/Int64', loop('a.hi32 = 0xfedcba98; a.lo32 = i; ret = a.grabDouble()',new Int64()));
+}
+
+function benchMisc() {
+  var len=4096, col=new Float64Array(len), dst=new Float64Array(len);
+  new Uint32Array(col.buffer).forEach(function(v,i,arr) { arr[i]=(Math.random()*0x100000000)>>>0; });
+
+  bench('hrtime+out', loop('b.hrtime(a)',new UInt64(),u64));
+  bench('popcntBatch', loop('b.popcntBatch(a, c)',col,u64,dst), len);
+  bench('pdepBatch', loop('b.pdepBatch(a, 0x5555, c)',col,u64,dst), len);
+
+  var filter=new u64.BloomFilter(1<<20);
+  bench('BloomFilter/add', loop('a.add(i)',filter));
+  bench('BloomFilter/has', loop('ret = a.has(i)',filter));
+  bench('BloomFilter/addBatch', loop('a.addBatch(b)',filter,col), len);
+  bench('BloomFilter/hasBatch', loop('a.hasBatch(b, c)',filter,col,Buffer.alloc(len/8)), len);
+
+  var hist=new u64.Histogram();
+  bench('Histogram/record', loop('a.record(i)',hist));
+  bench('Histogram/recordBatch', loop('a.recordBatch(b)',hist,col), len);
+  bench('Histogram/percentile', loop('ret = a.percentile(99)',hist));
+}
+
+function benchNative() {
+  var exe=path.join(__dirname,'u64bench');
+  if (!fs.existsSync(exe)) {
+    console.error('(skipping native benchmarks: run make -C bench)');
+    return;
+  }
+  var args=opts.filter ? [opts.filter] : [];
+  results=results.concat(JSON.parse(child_process.execFileSync(exe,args,{encoding:'utf8'})));
+}
+
+function compare(baseline) {
+  var base={}, regressions=0;
+  baseline.results.forEach(function(r) { base[r.name]=r.ns; });
+  results.forEach(function(r) {
+    if (!(r.name in base)) {
+      return;
+    }
+    var delta=(r.ns/base[r.name]-1)*100, flag='';
+    if (delta>opts.threshold) {
+      flag='  REGRESSION';
+      regressions++;
+    }
+    console.log(pad(r.name,50)+pad(base[r.name].toFixed(2),12)+pad(r.ns.toFixed(2),12)+
+                pad((delta>=0 ? '+' : '')+delta.toFixed(1)+'%',10)+flag);
+  });
+  return regressions;
+}
+
+function pad(s,n) {
+  return (s.length<n) ? s+new Array(n-s.length+1).join(' ') : s+' ';
+}
+
+benchOps();
+benchConstructors();
+benchStrings();
+benchDoubles();
+benchMisc();
+benchNative();
+
+var report={
+  date: new Date().toISOString(),
+  node: process.version,
+  kernels: u64.cpuFeatures().kernels,
+  results: results
+};
+if (opts.out) {
+  fs.writeFileSync(opts.out,JSON.stringify(report,null,1)+'\n');
+}
+if (opts.compare) {
+  var baseline=JSON.parse(fs.readFileSync(opts.compare,'utf8'));
+  console.log(pad('name',50)+pad('base ns',12)+pad('ns',12)+'delta');
+  process.exitCode=compare(baseline) ? 1 : 0;
+} else {
+  results.forEach(function(r) {
+    console.log(pad(r.name,50)+r.ns.toFixed(2)+' ns');
+  });
+}
@@ -0,0 +1,238 @@
+// native micro-benchmarks; prints [{"name":...,"ns":...,"iterations":...},...]
+// usage: u64bench [filter-substring]
+
+#include "u64str.h"
+#include "kernels.h"
+#include "ext/cpuid.h"
+#include "ext/binary64util.h"
+#include "ext/bitops.h"
+#include "ext/shifts.h"
+#include "ext/adc_sbb.h"
+#include "ext/blockbloom.h"
+#include "ext/loghist.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+static const char *filter = 0;
+static bool first = true;
+static volatile uint64_t sink;
+
+static double now_ns()
+{
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// fn(iterations) runs the measured operation that often; per-op time is the best of 5 runs of >=20ms
+template <typename Fn>
+static void bench(const std::string &name,size_t opsPerCall,Fn fn)
+{
+  if ( (filter)&&(!strstr(name.c_str(), filter)) ) {
+    return;
+  }
+  size_t n = 1;
+  for (;;) {
+    const double start = now_ns();
+    fn(n);
+    if (now_ns() - start > 20e6) {
+      break;
+    }
+    n *= 2;
+  }
+  double best = 1e300;
+  for (int run=0; run<5; run++) {
+    const double start = now_ns();
+    fn(n);
+    const double t = (now_ns() - start) / ((double)n * opsPerCall);
+    if (t < best) {
+      best = t;
+    }
+  }
+  printf("%s\n  {\"name\":\"native/%s\",\"ns\":%.4f,\"iterations\":%zu}", (first) ? "[" : ",", name.c_str(), best, n*opsPerCall);
+  first = false;
+}
+
+// xorshift, so the compiler cannot precompute inputs
+static inline uint64_t next(uint64_t &x)
+{
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  return x;
+}
+
+static void benchStrings()
+{
+  static const int radixes[] = { 2, 8, 10, 16, 36 };
+  char scratch[66];
+  for (size_t i=0; i<sizeof(radixes)/sizeof(*radixes); i++) {
+    const int radix = radixes[i];
+    bench("u64ToString/radix" + std::to_string(radix), 1, [&](size_t n) {
+      uint64_t x = 0x9e3779b97f4a7c15, acc = 0;
+      for (size_t j=0; j<n; j++) {
+        acc += *u64ToString(next(x), radix, scratch);
+      }
+      sink = acc;
+    });
+  }
+
+  static const char *inputs[][2] = {
+    { "dec", "18446744073709551615" },
+    { "dec-short", "12345" },
+    { "hex", "0xffffffffffffffff" },
+    { "dec-underscores", "18_446_744_073_709_551_615" }
+  };
+  for (size_t i=0; i<sizeof(inputs)/sizeof(*inputs); i++) {
+    const char *volatile str = inputs[i][1]; // re-read every iteration: no hoisting
+    const size_t len = strlen(str);
+    bench(std::string("u64FromString/") + inputs[i][0], 1, [&](size_t n) {
+      uint64_t acc = 0;
+      for (size_t j=0; j<n; j++) {
+        const char *s = str;
+        acc += u64FromString(s, s + len);
+      }
+      sink = acc;
+    });
+    bench(std::string("u64ParseString/") + inputs[i][0], 1, [&](size_t n) {
+      uint64_t acc = 0, val = 0;
+      for (size_t j=0; j<n; j++) {
+        const char *s = str;
+        u64ParseString(s, s + len, 0, &val);
+        acc += val;
+      }
+      sink = acc;
+    });
+  }
+}
+
+static void benchDoubles()
+{
+  bench("buildBinary64Dbl", 1, [](size_t n) {
+    uint64_t x = 0x9e3779b97f4a7c15;
+    double acc = 0;
+    for (size_t j=0; j<n; j++) {
+      const uint64_t r = next(x);
+      acc += buildBinary64Dbl(+1, (r >> 12) | 0x10000000000000, (int)(r & 0x3ff) - 511);
+    }
+    sink = (uint64_t)acc;
+  });
+  bench("splitBinary64Dbl", 1, [](size_t n) {
+    uint64_t x = 0x9e3779b97f4a7c15, acc = 0;
+    int sign, exponent;
+    uint64_t mantissa;
+    for (size_t j=0; j<n; j++) {
+      acc += splitBinary64Dbl((double)next(x), &sign, &mantissa, &exponent) + mantissa + exponent;
+    }
+    sink = acc;
+  });
+}
+
+// expr: one op on val; pre: name prefix
+#define SCALAR(fn, expr) \
+  bench(pre + #fn, 1, [&](size_t n) {                 \
+    uint64_t x = 0x9e3779b97f4a7c15, acc = 0;         \
+    for (size_t j=0; j<n; j++) {                      \
+      const uint64_t val = next(x);                   \
+      acc += (expr);                                  \
+    }                                                 \
+    sink = acc;                                       \
+  });
+
+// single instructions on every ISA: inlined from ext/, not in the kernel table
+static void benchScalar()
+{
+  const std::string pre = "scalar/";
+  SCALAR(shl64,    shl64(val, (unsigned int)val))
+  SCALAR(sar64,    sar64(val, (unsigned int)val))
+  SCALAR(rol64,    rol64(val, (unsigned int)val))
+  uint64_t r;
+  SCALAR(adc64,    adc64(r, val, acc, val & 1) + r)
+  SCALAR(sbb64,    sbb64(r, val, acc, val & 1) + r)
+}
+
+static void benchKernels(const u64_kernels &k)
+{
+  const std::string pre = std::string("kernel/") + k.name + "/";
+
+  SCALAR(clz64,    k.clz64(val >> (val & 63)))
+  SCALAR(ctz64,    k.ctz64(val << (val & 63)))
+  SCALAR(popcnt64, k.popcnt64(val))
+  SCALAR(parity64, k.parity64(val))
+  SCALAR(pdep64,   k.pdep64(val, val * 0xff51afd7ed558ccd))
+  SCALAR(pext64,   k.pext64(val, val * 0xff51afd7ed558ccd))
+#undef SCALAR
+
+  const size_t len = 4096;
+  std::vector<uint64_t> src(len), dst(len);
+  uint64_t x = 0x9e3779b97f4a7c15;
+  for (size_t i=0; i<len; i++) {
+    src[i] = next(x);
+  }
+
+  static const struct { const char *name; int op; } ops[] = {
+    {"popcnt", BITOP_POPCNT}, {"parity", BITOP_PARITY}, {"bswap", BITOP_BSWAP},
+    {"bitReverse", BITOP_BITREVERSE}, {"pdep", BITOP_PDEP}, {"pext", BITOP_PEXT},
+    {"blsr", BITOP_BLSR}, {"blsi", BITOP_BLSI}, {"extractBits", BITOP_EXTRACT}, {"insertBits", BITOP_INSERT}
+  };
+  for (size_t i=0; i<sizeof(ops)/sizeof(*ops); i++) {
+    const int op = ops[i].op;
+    bench(pre + "bitop_batch/" + ops[i].name, len, [&](size_t n) {
+      for (size_t j=0; j<n; j++) {
+        k.bitop_batch(op, &dst[0], &src[0], len, 0x5555555555555555, 7, 21);
+      }
+      sink = dst[len-1];
+    });
+  }
+
+  std::vector<uint64_t> words(BLOOM_BLOCK_WORDS << 14); // 1 MiB
+  std::vector<uint8_t> bits(len / 8);
+  bench(pre + "bloom_insert_batch", len, [&](size_t n) {
+    for (size_t j=0; j<n; j++) {
+      k.bloom_insert_batch(&words[0], 1 << 14, &src[0], len, 0);
+    }
+  });
+  bench(pre + "bloom_probe_batch", len, [&](size_t n) {
+    for (size_t j=0; j<n; j++) {
+      k.bloom_probe_batch(&words[0], 1 << 14, &src[0], len, &bits[0]);
+    }
+    sink = bits[0];
+  });
+
+  std::vector<uint64_t> counts(loghist_buckets(8));
+  bench(pre + "loghist_record_batch", len, [&](size_t n) {
+    uint64_t min = ~(uint64_t)0, max = 0;
+    for (size_t j=0; j<n; j++) {
+      k.loghist_record_batch(&counts[0], 8, &src[0], len, &min, &max);
+    }
+    sink = min + max;
+  });
+}
+
+int main(int argc,char **argv)
+{
+  if (argc > 1) {
+    filter = argv[1];
+  }
+
+  benchStrings();
+  benchDoubles();
+  benchScalar();
+
+  const unsigned int features = u64k_cpu_features();
+  const u64_kernels *variants[] = {
+    &u64k_generic,
+#ifdef U64K_X86
+    &u64k_sse42, &u64k_avx2, &u64k_avx512,
+#endif
+  };
+  for (size_t i=0; i<sizeof(variants)/sizeof(*variants); i++) {
+    if ((variants[i]->required & features) == variants[i]->required) {
+      benchKernels(*variants[i]);
+    }
+  }
+
+  printf("%s\n]\n", (first) ? "[" : "");
+  return 0;
+}
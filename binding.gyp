@@ -1,9 +1,51 @@
 {
+  "variables": {
+    "u64_stats%": 0, # 1: per-op counters/timing for u64.stats() (cf. stats.h)
+    "u64_kernel_flags_sse42": ["-msse4.2","-mpopcnt"],
+    "u64_kernel_flags_avx2": ["-msse4.2","-mpopcnt","-mavx2","-mlzcnt","-mbmi","-mbmi2"],
+    "u64_kernel_flags_avx512": ["-msse4.2","-mpopcnt","-mavx2","-mlzcnt","-mbmi","-mbmi2",
+                                "-mavx512f","-mavx512cd","-mavx512vl","-mavx512bw","-mavx512dq"]
+  },
   "targets": [{
     "target_name": "u64",
-    "sources": ["main.cc","uint64.cc","u64str.c"],
+    "sources": ["main.cc","addondata.cc","uint64.cc","u64str.c","column.cc","bloomfilter.cc","histogram.cc","batch.cc",
+                "stats.cc","textparser.cc","mappedfile.cc","modulus.cc","scan.cc","selection.cc","recordschema.cc","fixedpoint.cc",
+                "kernels.cc","kernels_generic.cc"],
     "include_dirs": [
       "<!(node -e \"require('nan')\")"
+    ],
+    "conditions": [
+      ['OS!="win" and target_arch=="x64"', {
+        "defines": ["U64K_X86"],
+        "dependencies": ["u64_kernels_sse42","u64_kernels_avx2","u64_kernels_avx512"]
+      }],
+      ['u64_stats==1', {
+        "defines": ["U64_STATS"]
+      }]
     ]
-  }]
+  }],
+  "conditions": [
+    ['OS!="win" and target_arch=="x64"', {
+      # one static library per ISA variant: gyp has no per-file cflags
+      "targets": [{
+        "target_name": "u64_kernels_sse42",
+        "type": "static_library",
+        "sources": ["kernels_sse42.cc"],
+        "cflags": ["<@(u64_kernel_flags_sse42)"],
+        "xcode_settings": { "OTHER_CFLAGS": ["<@(u64_kernel_flags_sse42)"] }
+      }, {
+        "target_name": "u64_kernels_avx2",
+        "type": "static_library",
+        "sources": ["kernels_avx2.cc"],
+        "cflags": ["<@(u64_kernel_flags_avx2)"],
+        "xcode_settings": { "OTHER_CFLAGS": ["<@(u64_kernel_flags_avx2)"] }
+      }, {
+        "target_name": "u64_kernels_avx512",
+        "type": "static_library",
+        "sources": ["kernels_avx512.cc"],
+        "cflags": ["<@(u64_kernel_flags_avx512)"],
+        "xcode_settings": { "OTHER_CFLAGS": ["<@(u64_kernel_flags_avx512)"] }
+      }]
+    }]
+  ]
 }
@@ -0,0 +1,215 @@
+#include "bloomfilter.h"
+#include "addondata.h"
+#include "uint64.h"
+#include "column.h"
+#include "kernels.h"
+#include "ext/blockbloom.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+NAN_MODULE_INIT(BloomFilter::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("BloomFilter").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->bloomFilterTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("buffer").ToLocalChecked(), GetBuffer);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("blocks").ToLocalChecked(), GetBlocks);
+
+  Nan::SetPrototypeMethod(tpl, "add", Add);
+  Nan::SetPrototypeMethod(tpl, "has", Has);
+  Nan::SetPrototypeMethod(tpl, "addBatch", AddBatch);
+  Nan::SetPrototypeMethod(tpl, "hasBatch", HasBatch);
+  Nan::SetPrototypeMethod(tpl, "clear", Clear);
+
+  Nan::Set(target, Nan::New("BloomFilter").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+BloomFilter *BloomFilter::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->bloomFilterTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad BloomFilter object");
+    return 0;
+  }
+  BloomFilter *obj = Nan::ObjectWrap::Unwrap<BloomFilter>(info.Holder());
+  // a plain ArrayBuffer can be detached (e.g. transferred by postMessage), freeing words
+  if ( (!obj->shared)&&(Nan::New(obj->buffer).As<v8::ArrayBuffer>()->ByteLength() == 0) ) {
+    Nan::ThrowError("BloomFilter buffer was detached");
+    return 0;
+  }
+  return obj;
+}
+
+#if NODE_MAJOR_VERSION >= 14
+static void FreeZeroed(void *data,size_t length,void *hint)
+{
+  free(data);
+}
+#endif
+
+// zero-filled (Shared)ArrayBuffer from calloc: RangeError instead of V8's fatal out-of-memory
+static bool NewZeroedBuffer(size_t bytes,bool shared,v8::Local<v8::Object> &ret,void *&data)
+{
+  data = calloc(bytes, 1);
+  if (!data) {
+    Nan::ThrowRangeError("Cannot allocate BloomFilter buffer");
+    return false;
+  }
+  v8::Isolate *isolate = v8::Isolate::GetCurrent();
+#if NODE_MAJOR_VERSION >= 14
+  if (shared) {
+    ret = v8::SharedArrayBuffer::New(isolate, v8::SharedArrayBuffer::NewBackingStore(data, bytes, FreeZeroed, 0));
+  } else {
+    ret = v8::ArrayBuffer::New(isolate, v8::ArrayBuffer::NewBackingStore(data, bytes, FreeZeroed, 0));
+  }
+#else
+  // internalized: V8 frees data through node's allocator, i.e. free()
+  if (shared) {
+    ret = v8::SharedArrayBuffer::New(isolate, data, bytes, v8::ArrayBufferCreationMode::kInternalized);
+  } else {
+    ret = v8::ArrayBuffer::New(isolate, data, bytes, v8::ArrayBufferCreationMode::kInternalized);
+  }
+#endif
+  return true;
+}
+
+NAN_METHOD(BloomFilter::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("BloomFilter must be called with new");
+    return;
+  }
+
+  v8::Local<v8::Object> buffer;
+  void *data;
+  size_t bytes;
+  bool shared;
+  if (info[0]->IsNumber()) {
+    const double size = info[0]->NumberValue();
+    const size_t maxBytes = node::Buffer::kMaxLength & ~(size_t)(BLOOM_BLOCK_BYTES-1);
+    if ( (!(size > 0))||(size > (double)maxBytes) ) {
+      char msg[96];
+      snprintf(msg, sizeof(msg), "Size must be between 1 and %lu bytes", (unsigned long)maxBytes);
+      Nan::ThrowRangeError(msg);
+      return;
+    }
+    bytes = ((size_t)size + BLOOM_BLOCK_BYTES-1) & ~(size_t)(BLOOM_BLOCK_BYTES-1);
+    shared = info[1]->BooleanValue();
+    if (!NewZeroedBuffer(bytes, shared, buffer, data)) {
+      return;
+    }
+  } else if (info[0]->IsSharedArrayBuffer()) {
+    v8::SharedArrayBuffer::Contents contents = info[0].As<v8::SharedArrayBuffer>()->GetContents();
+    data = contents.Data();
+    bytes = contents.ByteLength();
+    shared = true;
+    buffer = info[0].As<v8::Object>();
+  } else if (info[0]->IsArrayBuffer()) {
+    // copied: the caller may still transfer or detach its ArrayBuffer
+    bytes = info[0].As<v8::ArrayBuffer>()->ByteLength();
+    shared = false;
+    if ( (bytes)&&(bytes%BLOOM_BLOCK_BYTES == 0)&&(bytes/BLOOM_BLOCK_BYTES <= 0xffffffff) ) {
+      if (!NewZeroedBuffer(bytes, false, buffer, data)) {
+        return;
+      }
+      memcpy(data, info[0].As<v8::ArrayBuffer>()->GetContents().Data(), bytes);
+    }
+  } else {
+    Nan::ThrowTypeError("Expected size in bytes, ArrayBuffer or SharedArrayBuffer as first argument");
+    return;
+  }
+
+  if ( (bytes == 0)||(bytes%BLOOM_BLOCK_BYTES != 0)||(bytes/BLOOM_BLOCK_BYTES > 0xffffffff) ) {
+    Nan::ThrowRangeError("Buffer size must be a non-zero multiple of 64 bytes");
+    return;
+  } else if ((uintptr_t)data%sizeof(uint64_t) != 0) {
+    Nan::ThrowRangeError("Buffer must be 8 byte aligned");
+    return;
+  }
+
+  BloomFilter *obj = new BloomFilter(buffer, (uint64_t *)data, bytes/BLOOM_BLOCK_BYTES, shared);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(BloomFilter::GetBuffer)
+{
+  BloomFilter *obj = Nan::ObjectWrap::Unwrap<BloomFilter>(info.Holder());
+  info.GetReturnValue().Set(Nan::New(obj->buffer));
+}
+
+NAN_GETTER(BloomFilter::GetBlocks)
+{
+  BloomFilter *obj = Nan::ObjectWrap::Unwrap<BloomFilter>(info.Holder());
+  info.GetReturnValue().Set((double)obj->blocks);
+}
+
+NAN_METHOD(BloomFilter::Add)
+{
+  BloomFilter *obj = This(info);
+  uint64_t key;
+  if ( (obj)&&(UInt64::FromArgument(info[0],key)) ) {
+    const uint64_t hash = bloom_hash64(key);
+    uint64_t *block = obj->words + bloom_block(hash, obj->blocks) * BLOOM_BLOCK_WORDS;
+    if (obj->shared) {
+      bloom_insert_atomic(block, hash);
+    } else {
+      bloom_insert(block, hash);
+    }
+  }
+}
+
+NAN_METHOD(BloomFilter::Has)
+{
+  BloomFilter *obj = This(info);
+  uint64_t key;
+  if ( (obj)&&(UInt64::FromArgument(info[0],key)) ) {
+    const uint64_t hash = bloom_hash64(key);
+    const uint64_t *block = obj->words + bloom_block(hash, obj->blocks) * BLOOM_BLOCK_WORDS;
+    info.GetReturnValue().Set((bool)bloom_probe(block, hash));
+  }
+}
+
+NAN_METHOD(BloomFilter::AddBatch)
+{
+  BloomFilter *obj = This(info);
+  U64Column keys;
+  if ( (obj)&&(U64Column::FromArgument(info[0],keys)) ) {
+    u64k->bloom_insert_batch(obj->words, obj->blocks, keys.data, keys.length, obj->shared);
+  }
+}
+
+NAN_METHOD(BloomFilter::HasBatch)
+{
+  BloomFilter *obj = This(info);
+  U64Column keys;
+  if ( (!obj)||(!U64Column::FromArgument(info[0],keys)) ) {
+    return;
+  }
+  const size_t outLen = (keys.length + 7) / 8;
+
+  v8::Local<v8::Object> out;
+  if (info[1]->IsUndefined()) {
+    out = Nan::NewBuffer(outLen).ToLocalChecked();
+  } else if (!info[1]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as second argument");
+    return;
+  } else if (node::Buffer::Length(info[1]) < outLen) {
+    Nan::ThrowRangeError("Output buffer too small");
+    return;
+  } else {
+    out = info[1].As<v8::Object>();
+  }
+
+  u64k->bloom_probe_batch(obj->words, obj->blocks, keys.data, keys.length, (uint8_t *)node::Buffer::Data(out));
+  info.GetReturnValue().Set(out);
+}
+
+NAN_METHOD(BloomFilter::Clear)
+{
+  if (BloomFilter *obj = This(info)) {
+    memset(obj->words, 0, obj->blocks * BLOOM_BLOCK_BYTES);
+  }
+}
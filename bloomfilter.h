@@ -0,0 +1,51 @@
+#ifndef _BLOOMFILTER_H
+#define _BLOOMFILTER_H
+
+#include <nan.h>
+
+/* Provides:
+
+new u64.BloomFilter(bytes[,shared=false])  - rounded up to 64 byte blocks, backed by a fresh (Shared)ArrayBuffer;
+                                             RangeError beyond node's max. Buffer length or if out of memory
+new u64.BloomFilter(buffer)                - attach to an existing SharedArrayBuffer (e.g. filter.buffer from another worker),
+                                             or copy a plain ArrayBuffer (e.g. a saved filter)
+
+.add(key)                  - key: Number, String, BigInt or UInt64
+.has(key):bool             - false: definitely not present
+.addBatch(column)          - packed u64 column
+.hasBatch(column[,out]):Buffer  - bitmask, bit (i&7) of out[i>>3] set iff column[i] maybe present
+.clear()
+.buffer                    - backing (Shared)ArrayBuffer
+.blocks                    - number of 64 byte blocks
+
+* filters backed by a SharedArrayBuffer use atomic inserts, so workers can add concurrently
+* a plain .buffer can be transferred (postMessage); the filter throws afterwards
+*/
+
+class BloomFilter : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  BloomFilter(v8::Local<v8::Object> buffer,uint64_t *words,size_t blocks,bool shared)
+    : buffer(buffer), words(words), blocks(blocks), shared(shared) {}
+  ~BloomFilter() { buffer.Reset(); }
+
+  Nan::Persistent<v8::Object> buffer; // keeps words alive
+  uint64_t *words;
+  size_t blocks;
+  bool shared;
+
+  static BloomFilter *This(Nan::NAN_METHOD_ARGS_TYPE info);
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetBuffer);
+  static NAN_GETTER(GetBlocks);
+
+  static NAN_METHOD(Add);
+  static NAN_METHOD(Has);
+  static NAN_METHOD(AddBatch);
+  static NAN_METHOD(HasBatch);
+  static NAN_METHOD(Clear);
+};
+
+#endif
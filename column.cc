@@ -0,0 +1,63 @@
+#include "column.h"
+#include "uint64.h"
+
+bool U64Column::HasInstance(v8::Local<v8::Value> value)
+{
+  return (value->IsArrayBufferView())&&
+         (node::Buffer::Length(value)%sizeof(uint64_t) == 0);
+}
+
+bool U64Column::FromArgument(v8::Local<v8::Value> arg,U64Column &ret)
+{
+  if (!arg->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Column must be a TypedArray, DataView or Buffer");
+    return false;
+  }
+  const size_t len = node::Buffer::Length(arg);
+  char *data = node::Buffer::Data(arg);
+  if (len%sizeof(uint64_t) != 0) {
+    Nan::ThrowRangeError("Column byteLength must be a multiple of 8");
+    return false;
+  } else if ((uintptr_t)data%sizeof(uint64_t) != 0) { // e.g. Buffer.slice() at odd offset
+    Nan::ThrowRangeError("Column must be 8 byte aligned");
+    return false;
+  }
+  ret.data = (uint64_t *)data;
+  ret.length = len / sizeof(uint64_t);
+  return true;
+}
+
+bool U64Column::DstArgument(Nan::NAN_METHOD_ARGS_TYPE info,int idx,const U64Column &src,U64Column &dst)
+{
+  if (info[idx]->IsUndefined()) {
+    dst = src;
+    return true;
+  } else if (!FromArgument(info[idx],dst)) {
+    return false;
+  } else if (dst.length < src.length) {
+    Nan::ThrowRangeError("Destination column too short");
+    return false;
+  }
+  return true;
+}
+
+bool U64Column::OperandArgument(v8::Local<v8::Value> arg,size_t n,uint64_t &scalar,const uint64_t *&ptr,size_t &step,bool withSign)
+{
+  if (arg->IsArrayBufferView()) {
+    U64Column col;
+    if (!FromArgument(arg,col)) {
+      return false;
+    } else if (col.length < n) {
+      Nan::ThrowRangeError("Operand column too short");
+      return false;
+    }
+    ptr = col.data;
+    step = 1;
+    return true;
+  } else if (!UInt64::FromArgument(arg,scalar,withSign)) {
+    return false;
+  }
+  ptr = &scalar;
+  step = 0;
+  return true;
+}
@@ -0,0 +1,28 @@
+#ifndef _COLUMN_H
+#define _COLUMN_H
+
+#include <nan.h>
+
+// packed u64 column: any ArrayBufferView (Buffer, BigUint64Array, Float64Array, ...)
+// whose byteLength is a multiple of 8; values are host-endian uint64_t.
+// The data pointer is only valid until the next call into JS.
+struct U64Column {
+  uint64_t *data;
+  size_t length;
+
+  U64Column() : data(0), length(0) {}
+
+  static bool HasInstance(v8::Local<v8::Value> value);
+  static bool FromArgument(v8::Local<v8::Value> arg,U64Column &ret);
+  // dst is info[idx], or src if undefined
+  static bool DstArgument(Nan::NAN_METHOD_ARGS_TYPE info,int idx,const U64Column &src,U64Column &dst);
+  // column (elementwise, at least n long: step 1) or single value (ptr = &scalar, step 0)
+  static bool OperandArgument(v8::Local<v8::Value> arg,size_t n,uint64_t &scalar,const uint64_t *&ptr,size_t &step,bool withSign=false);
+
+  // largest Nan::NewBuffer(size) (uint32_t) that stays within node::Buffer::kMaxLength
+  static size_t MaxNewBytes() {
+    return ((uint64_t)node::Buffer::kMaxLength < 0xffffffff) ? (size_t)node::Buffer::kMaxLength : (size_t)0xffffffff;
+  }
+};
+
+#endif
@@ -0,0 +1,39 @@
+// u64.mapFile(path[,options]):MappedFile, cf. mappedfile.h
+//   options: readonly (true), offset (0), length (to end of data) - bytes, relative to the data;
+//            header (undefined: detect, true: required, false: raw)
+// u64.createColumnFile(path,count[,options])  - new (zero-filled) file with header, e.g. for mapFile(path,{readonly:false})
+//   options: signed (false), bigEndian (false)
+
+var fs=require('fs');
+var u64=require('./build/Release/u64.node');
+
+var HEADER_SIZE=32, VERSION=1, FLAG_SIGNED=0x01, FLAG_BIGENDIAN=0x02;
+
+function mapFile(path,options) {
+  options=options || {};
+  var readonly=(options.readonly!==undefined) ? !!options.readonly : true;
+  return new u64.MappedFile(path,readonly,options.offset,options.length,options.header);
+}
+
+function createColumnFile(path,count,options) {
+  options=options || {};
+  if (!(count>=0) || count!==Math.floor(count)) {
+    throw new RangeError('count must be a non-negative integer');
+  }
+  var header=Buffer.alloc(HEADER_SIZE);
+  header.write('U64C',0,'latin1');
+  header[4]=VERSION;
+  header[5]=(options.signed ? FLAG_SIGNED : 0) | (options.bigEndian ? FLAG_BIGENDIAN : 0);
+  header.writeUInt32LE(count%0x100000000,8);
+  header.writeUInt32LE(Math.floor(count/0x100000000),12);
+
+  var fd=fs.openSync(path,'w');
+  try {
+    fs.writeSync(fd,header,0,HEADER_SIZE,0);
+    fs.ftruncateSync(fd,HEADER_SIZE+count*8);
+  } finally {
+    fs.closeSync(fd);
+  }
+}
+
+module.exports={mapFile:mapFile, createColumnFile:createColumnFile};
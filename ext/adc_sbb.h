@@ -8,7 +8,7 @@
 static inline bool adc64(uint64_t &ret,uint64_t a,uint64_t b,bool carry)
 {
   ret = a + b + carry;
-  return (ret < b) || (!b && ret == b);
+  return (ret < b) || (a && ret == b); // ret==b: a+carry is 0 or 2^64
 }
 
 static inline bool sbb64(uint64_t &ret,uint64_t a,uint64_t b,bool carry)
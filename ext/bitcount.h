@@ -15,7 +15,12 @@ Count trailing zeros
 - unsigned int ctz64(uint64_t)
 * ffs(FindFirstSet) is (ctz+1) [but usually 33/65->0]
 
-- unsigned int popcnt32(uint32_t)  (no popcnt64 (yet))
+Population count
+- unsigned int popcnt32(uint32_t)
+- unsigned int popcnt64(uint64_t)
+
+* compiled with -mpopcnt / -mlzcnt / -mbmi (gcc, clang) the hardware instructions are used,
+  which the CPU must support -- cf. kernels.h for runtime selection
 */
 
 #ifdef __cplusplus
@@ -81,50 +86,79 @@ static inline unsigned int ctz32(const uint32_t val)
 #  endif
 
 #elif (defined(__GNUC__) || defined(__clang__)) && (__SIZEOF_INT__ == 4)  // gcc since 3.4.0,  clang: __has_builtin(__builtin_clz) ...
-#if defined(__clang__) && __has_builtin(__builtin_popcnt)
-// Don't use __builtin_popcount on gcc (only since gcc 4.5; only calls __popcountsi2 - or even __popcountdi2)
+#if (defined(__clang__) && __has_builtin(__builtin_popcnt)) || defined(__POPCNT__)
+// Don't use __builtin_popcount on gcc without -mpopcnt (only since gcc 4.5; only calls __popcountsi2 - or even __popcountdi2)
 #define _BITCOUNT_H_HASPOP
 
 static inline unsigned int popcnt32(const uint32_t val)
 {
   return __builtin_popcount(val);
 }
+
+#  if defined(__POPCNT__) && (__SIZEOF_LONG__ == 8)
+#define _BITCOUNT_H_HASPOP64
+
+static inline unsigned int popcnt64(const uint64_t val)
+{
+  return __builtin_popcountl(val);
+}
+#  endif
+#endif
+
+#if defined(__LZCNT__) || defined(__BMI__)
+#include <x86intrin.h>  // lzcnt/tzcnt are defined for 0 (but execute as bsr/bsf on older CPUs!)
 #endif
 
 static inline unsigned int clz32(const uint32_t val)
 {
+#ifdef __LZCNT__
+  return _lzcnt_u32(val);
+#else
   if (!val) { // TODO?! unlikely ?
     return 32;
   }
   return __builtin_clz(val);
+#endif
 }
 
 static inline unsigned int ctz32(const uint32_t val)
 {
+#ifdef __BMI__
+  return _tzcnt_u32(val);
+#else
   if (!val) {
     return 32;
   }
   return __builtin_ctz(val);
+#endif
 }
 
 // Note: Don't use __builtin_clzll/ctlll on 32bit, because gcc will not inline but emit call to __clzdi2/...
-#  if __SIZEOF_LONG_INT__ == 8  // TODO? and LLP64 ?
+#  if __SIZEOF_LONG__ == 8  // TODO? and LLP64 ?
 #define _BITCOUNT_H_HAS64
 
 static inline unsigned int clz64(const uint64_t val)
 {
+#ifdef __LZCNT__
+  return _lzcnt_u64(val);
+#else
   if (!val) {
     return 64;
   }
   return __builtin_clzl(val);
+#endif
 }
 
 static inline unsigned int ctz64(const uint64_t val)
 {
+#ifdef __BMI__
+  return _tzcnt_u64(val);
+#else
   if (!val) {
     return 64;
   }
   return __builtin_ctzl(val);
+#endif
 }
 #  endif
 
@@ -165,6 +199,19 @@ static inline unsigned int popcnt32(uint32_t val)
 #endif
 
 
+#ifdef _BITCOUNT_H_HASPOP64
+#undef _BITCOUNT_H_HASPOP64
+#else
+static inline unsigned int popcnt64(uint64_t val)
+{
+  val -= (val>>1) & 0x5555555555555555;
+  val = ((val>>2) & 0x3333333333333333) + (val & 0x3333333333333333);
+  val = ((val>>4) + val) & 0x0f0f0f0f0f0f0f0f;
+  return (val*0x0101010101010101) >> 56;
+}
+#endif
+
+
 #ifdef _BITCOUNT_H_HAS64
 #undef _BITCOUNT_H_HAS64
 #else
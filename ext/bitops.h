@@ -0,0 +1,179 @@
+#ifndef _BITOPS_H
+#define _BITOPS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "bitcount.h"
+
+/* Provides:
+
+- unsigned int parity64(uint64_t)           - popcnt64(x)&1
+- uint64_t bswap64(uint64_t)
+- uint64_t bitreverse64(uint64_t)
+- uint64_t pdep64(uint64_t val,uint64_t mask)  - deposit low bits of val at the set bits of mask
+- uint64_t pext64(uint64_t val,uint64_t mask)  - gather bits of val at the set bits of mask into the low bits
+- uint64_t blsr64(uint64_t)                 - clear lowest set bit
+- uint64_t blsi64(uint64_t)                 - isolate lowest set bit
+- uint64_t extractbits64(uint64_t val,unsigned int start,unsigned int len)
+- uint64_t insertbits64(uint64_t val,uint64_t bits,unsigned int start,unsigned int len)
+* bits at positions >= 64 are zero, i.e. start>=64 extracts 0 / inserts nothing, len is clipped
+
+- void bitop_batch(int op,uint64_t *dst,const uint64_t *src,size_t n,uint64_t mask,unsigned int start,unsigned int len)
+* op: BITOP_*; mask only for PDEP/PEXT, start+len only for EXTRACT/INSERT.
+  BITOP_INSERT inserts src[i] into dst[i]; all others compute dst[i] = op(src[i]) (dst==src allowed)
+
+* compiled with -mbmi2, pdep/pext use the BMI2 instructions
+  (CAVE: microcoded, i.e. slow, on AMD before Zen 3)
+*/
+
+#if defined(__BMI2__)
+#include <x86intrin.h>
+#elif defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+enum {
+  BITOP_POPCNT,
+  BITOP_PARITY,
+  BITOP_BSWAP,
+  BITOP_BITREVERSE,
+  BITOP_PDEP,
+  BITOP_PEXT,
+  BITOP_BLSR,
+  BITOP_BLSI,
+  BITOP_EXTRACT,
+  BITOP_INSERT
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline unsigned int parity64(uint64_t val)
+{
+#ifdef __POPCNT__
+  return popcnt64(val) & 1;
+#else
+  val ^= val >> 32;
+  val ^= val >> 16;
+  val ^= val >> 8;
+  val ^= val >> 4;
+  return (0x6996 >> (val & 0xf)) & 1; // parity lookup of 4 bits
+#endif
+}
+
+static inline uint64_t bswap64(uint64_t val)
+{
+#if defined(__GNUC__) || defined(__clang__)  // gcc since 4.3
+  return __builtin_bswap64(val);
+#elif defined(_MSC_VER)
+  return _byteswap_uint64(val);
+#else
+  val = ((val & 0x00ff00ff00ff00ff) << 8) | ((val >> 8) & 0x00ff00ff00ff00ff);
+  val = ((val & 0x0000ffff0000ffff) << 16) | ((val >> 16) & 0x0000ffff0000ffff);
+  return (val << 32) | (val >> 32);
+#endif
+}
+
+static inline uint64_t bitreverse64(uint64_t val)
+{
+  val = ((val & 0x5555555555555555) << 1) | ((val >> 1) & 0x5555555555555555);
+  val = ((val & 0x3333333333333333) << 2) | ((val >> 2) & 0x3333333333333333);
+  val = ((val & 0x0f0f0f0f0f0f0f0f) << 4) | ((val >> 4) & 0x0f0f0f0f0f0f0f0f);
+  return bswap64(val);
+}
+
+static inline uint64_t pdep64(uint64_t val,uint64_t mask)
+{
+#ifdef __BMI2__
+  return _pdep_u64(val, mask);
+#else
+  uint64_t ret = 0;
+  for (uint64_t bit=1; mask; bit+=bit) { // one iteration per set bit of mask
+    if (val & bit) {
+      ret |= mask & -mask;
+    }
+    mask &= mask - 1;
+  }
+  return ret;
+#endif
+}
+
+static inline uint64_t pext64(uint64_t val,uint64_t mask)
+{
+#ifdef __BMI2__
+  return _pext_u64(val, mask);
+#else
+  uint64_t ret = 0;
+  for (uint64_t bit=1; mask; bit+=bit) {
+    if (val & mask & -mask) {
+      ret |= bit;
+    }
+    mask &= mask - 1;
+  }
+  return ret;
+#endif
+}
+
+static inline uint64_t blsr64(uint64_t val)
+{
+  return val & (val - 1);
+}
+
+static inline uint64_t blsi64(uint64_t val)
+{
+  return val & -val;
+}
+
+static inline uint64_t _bitops_h_lenmask(unsigned int len)
+{
+  return (len >= 64) ? ~(uint64_t)0 : ((uint64_t)1 << len) - 1;
+}
+
+static inline uint64_t extractbits64(uint64_t val,unsigned int start,unsigned int len)
+{
+  if (start >= 64) {
+    return 0;
+  }
+  return (val >> start) & _bitops_h_lenmask(len);
+}
+
+static inline uint64_t insertbits64(uint64_t val,uint64_t bits,unsigned int start,unsigned int len)
+{
+  if (start >= 64) {
+    return val;
+  }
+  const uint64_t mask = _bitops_h_lenmask(len) << start;
+  return (val & ~mask) | ((bits << start) & mask);
+}
+
+#define _BITOPS_H_LOOP(expr) \
+  for (size_t i=0; i<n; i++) {       \
+    const uint64_t val = src[i];     \
+    dst[i] = (expr);                 \
+  }                                  \
+  break;
+
+static inline void bitop_batch(int op,uint64_t *dst,const uint64_t *src,size_t n,uint64_t mask,unsigned int start,unsigned int len)
+{
+  switch (op) {  // one loop per op, so each can be vectorized
+  case BITOP_POPCNT:     _BITOPS_H_LOOP(popcnt64(val))
+  case BITOP_PARITY:     _BITOPS_H_LOOP(parity64(val))
+  case BITOP_BSWAP:      _BITOPS_H_LOOP(bswap64(val))
+  case BITOP_BITREVERSE: _BITOPS_H_LOOP(bitreverse64(val))
+  case BITOP_PDEP:       _BITOPS_H_LOOP(pdep64(val, mask))
+  case BITOP_PEXT:       _BITOPS_H_LOOP(pext64(val, mask))
+  case BITOP_BLSR:       _BITOPS_H_LOOP(blsr64(val))
+  case BITOP_BLSI:       _BITOPS_H_LOOP(blsi64(val))
+  case BITOP_EXTRACT:    _BITOPS_H_LOOP(extractbits64(val, start, len))
+  case BITOP_INSERT:     _BITOPS_H_LOOP(insertbits64(dst[i], val, start, len))
+  }
+}
+
+#undef _BITOPS_H_LOOP
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
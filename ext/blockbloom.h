@@ -0,0 +1,155 @@
+#ifndef _BLOCKBLOOM_H
+#define _BLOCKBLOOM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Provides:
+
+Cache-line blocked ("split block") Bloom filter on 64bit keys:
+each key selects one 64 byte block (8 x uint64_t) and sets exactly one bit in every word of it.
+The 8 words are independent, so insert/probe vectorize (SSE2: 4x, AVX2: 2x, AVX-512: 1x).
+
+- uint64_t bloom_hash64(uint64_t key)
+- size_t bloom_block(uint64_t hash,size_t blocks)         - blocks < 2^32
+- void bloom_mask(uint64_t hash,uint64_t mask[8])
+- void bloom_insert(uint64_t *block,uint64_t hash)
+- void bloom_insert_atomic(uint64_t *block,uint64_t hash) - for filters shared between threads
+- int bloom_probe(const uint64_t *block,uint64_t hash)    - !=0: maybe present
+* block is bloom_block(hash,blocks) * BLOOM_BLOCK_WORDS words into the filter
+
+- void bloom_insert_batch(uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,int atomic)
+- void bloom_probe_batch(const uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,uint8_t *out)
+* out must hold (n+7)/8 bytes; bit (i&7) of out[i>>3] is set iff keys[i] maybe present
+*/
+
+#define BLOOM_BLOCK_WORDS 8
+#define BLOOM_BLOCK_BYTES 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// murmur3 fmix64: every input bit affects every output bit
+static inline uint64_t bloom_hash64(uint64_t key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccd;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53;
+  key ^= key >> 33;
+  return key;
+}
+
+// upper 32 bits select the block (multiply-shift instead of modulo)
+static inline size_t bloom_block(uint64_t hash,size_t blocks)
+{
+  return (size_t)(((hash >> 32) * (uint64_t)blocks) >> 32);
+}
+
+// lower 32 bits, multiplied by 8 odd salts, select one bit per word
+static inline void bloom_mask(uint64_t hash,uint64_t mask[BLOOM_BLOCK_WORDS])
+{
+  static const uint32_t salt[BLOOM_BLOCK_WORDS] = {
+    0x47b6137b, 0x44974d91, 0x8824ad5b, 0xa2b7289d,
+    0x705495c7, 0x2df1424b, 0x9efc4947, 0x5c6bfb31
+  };
+  const uint32_t h = (uint32_t)hash;
+  for (int i=0; i<BLOOM_BLOCK_WORDS; i++) {
+    mask[i] = (uint64_t)1 << ((uint32_t)(h * salt[i]) >> 26);
+  }
+}
+
+static inline void bloom_insert(uint64_t *block,uint64_t hash)
+{
+  uint64_t mask[BLOOM_BLOCK_WORDS];
+  bloom_mask(hash, mask);
+  for (int i=0; i<BLOOM_BLOCK_WORDS; i++) {
+    block[i] |= mask[i];
+  }
+}
+
+static inline void bloom_insert_atomic(uint64_t *block,uint64_t hash)
+{
+  uint64_t mask[BLOOM_BLOCK_WORDS];
+  bloom_mask(hash, mask);
+  for (int i=0; i<BLOOM_BLOCK_WORDS; i++) {
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_fetch_or(&block[i], mask[i], __ATOMIC_RELAXED);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    _InterlockedOr64((volatile __int64 *)&block[i], mask[i]);
+#else
+    block[i] |= mask[i]; // TODO? lost bits possible with concurrent writers
+#endif
+  }
+}
+
+static inline int bloom_probe(const uint64_t *block,uint64_t hash)
+{
+  uint64_t mask[BLOOM_BLOCK_WORDS], missing = 0;
+  bloom_mask(hash, mask);
+  for (int i=0; i<BLOOM_BLOCK_WORDS; i++) { // no early exit: keeps the loop branch-free
+    missing |= mask[i] & ~block[i];
+  }
+  return !missing;
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _BLOCKBLOOM_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define _BLOCKBLOOM_PREFETCH(p)
+#endif
+
+// keys are processed in groups of 8: hash + prefetch all blocks first, then touch them
+static inline void bloom_insert_batch(uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,int atomic)
+{
+  uint64_t hash[8];
+  size_t block[8];
+  for (size_t i=0; i<n; i+=8) {
+    const size_t m = (n-i < 8) ? n-i : 8;
+    for (size_t j=0; j<m; j++) {
+      hash[j] = bloom_hash64(keys[i+j]);
+      block[j] = bloom_block(hash[j], blocks) * BLOOM_BLOCK_WORDS;
+      _BLOCKBLOOM_PREFETCH(words + block[j]);
+    }
+    if (atomic) {
+      for (size_t j=0; j<m; j++) {
+        bloom_insert_atomic(words + block[j], hash[j]);
+      }
+    } else {
+      for (size_t j=0; j<m; j++) {
+        bloom_insert(words + block[j], hash[j]);
+      }
+    }
+  }
+}
+
+static inline void bloom_probe_batch(const uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,uint8_t *out)
+{
+  uint64_t hash[8];
+  size_t block[8];
+  for (size_t i=0; i<n; i+=8) {
+    const size_t m = (n-i < 8) ? n-i : 8;
+    for (size_t j=0; j<m; j++) {
+      hash[j] = bloom_hash64(keys[i+j]);
+      block[j] = bloom_block(hash[j], blocks) * BLOOM_BLOCK_WORDS;
+      _BLOCKBLOOM_PREFETCH(words + block[j]);
+    }
+    unsigned int bits = 0;
+    for (size_t j=0; j<m; j++) {
+      bits |= bloom_probe(words + block[j], hash[j]) << j;
+    }
+    out[i>>3] = bits;
+  }
+}
+
+#undef _BLOCKBLOOM_PREFETCH
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef _CPUID_H
+#define _CPUID_H
+
+/* Provides:
+
+- unsigned int cpu_features(void)   - CPU_* bits, 0 on non-x86
+* AVX2 / AVX-512 bits are only set, if the OS also saves the corresponding register state (xgetbv)
+*/
+
+#define CPU_SSE42     0x0001
+#define CPU_POPCNT    0x0002
+#define CPU_LZCNT     0x0004
+#define CPU_BMI1      0x0008
+#define CPU_BMI2      0x0010
+#define CPU_AVX2      0x0020
+#define CPU_AVX512F   0x0040
+#define CPU_AVX512CD  0x0080
+#define CPU_AVX512VL  0x0100
+#define CPU_AVX512BW  0x0200
+#define CPU_AVX512DQ  0x0400
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define _CPUID_H_X86
+#define _CPUID_H_CPUID(leaf,sub,r) __cpuidex((int *)(r),(leaf),(sub))
+#define _CPUID_H_XCR0() _xgetbv(0)
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <stdint.h>
+#define _CPUID_H_X86
+#define _CPUID_H_CPUID(leaf,sub,r) __cpuid_count((leaf),(sub),(r)[0],(r)[1],(r)[2],(r)[3])
+static inline uint64_t _cpuid_h_xgetbv0(void)
+{
+  uint32_t lo, hi;
+  __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0" : "=a"(lo), "=d"(hi) : "c"(0)); // xgetbv, w/o requiring -mxsave
+  return ((uint64_t)hi << 32) | lo;
+}
+#define _CPUID_H_XCR0() _cpuid_h_xgetbv0()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline unsigned int cpu_features(void)
+{
+  unsigned int ret = 0;
+#ifdef _CPUID_H_X86
+  unsigned int r[4]; // eax, ebx, ecx, edx
+  _CPUID_H_CPUID(0, 0, r);
+  const unsigned int maxLeaf = r[0];
+  if (maxLeaf < 1) {
+    return 0;
+  }
+
+  _CPUID_H_CPUID(1, 0, r);
+  if (r[2] & (1u<<20)) ret |= CPU_SSE42;
+  if (r[2] & (1u<<23)) ret |= CPU_POPCNT;
+  const int osxsave = (r[2] & (1u<<27)) != 0;
+  const unsigned int xcr0 = (osxsave) ? (unsigned int)_CPUID_H_XCR0() : 0;
+  const int avxState = (xcr0 & 0x06) == 0x06,     // XMM, YMM
+            avx512State = (xcr0 & 0xe6) == 0xe6;  // + opmask, ZMM_Hi256, Hi16_ZMM
+
+  if (maxLeaf >= 7) {
+    _CPUID_H_CPUID(7, 0, r);
+    if (r[1] & (1u<<3)) ret |= CPU_BMI1;
+    if (r[1] & (1u<<8)) ret |= CPU_BMI2;
+    if (avxState) {
+      if (r[1] & (1u<<5)) ret |= CPU_AVX2;
+    }
+    if (avx512State) {
+      if (r[1] & (1u<<16)) ret |= CPU_AVX512F;
+      if (r[1] & (1u<<17)) ret |= CPU_AVX512DQ;
+      if (r[1] & (1u<<28)) ret |= CPU_AVX512CD;
+      if (r[1] & (1u<<30)) ret |= CPU_AVX512BW;
+      if (r[1] & (1u<<31)) ret |= CPU_AVX512VL;
+    }
+  }
+
+  _CPUID_H_CPUID(0x80000000, 0, r);
+  if (r[0] >= 0x80000001) {
+    _CPUID_H_CPUID(0x80000001, 0, r);
+    if (r[2] & (1u<<5)) ret |= CPU_LZCNT; // "ABM"
+  }
+#endif
+  return ret;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef _FIXED64_H
+#define _FIXED64_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "u128.h"
+#include "modarith.h"
+
+/* Provides:
+
+Decimal fixed point on int64_t (stored as uint64_t): value = v / 10^scale, scale 0..18.
+Products and quotients use a 128 bit intermediate and are rounded once, according to FIX_* rounding.
+
+- void fix_init(struct fixctx *ctx,unsigned int scale,int rounding)
+- int fix_mul(const struct fixctx *ctx,uint64_t a,uint64_t b,uint64_t *ret)      - a*b / 10^scale
+- int fix_div(const struct fixctx *ctx,uint64_t a,uint64_t b,uint64_t *ret)      - a*10^scale / b
+- int fix_rescale(const struct fixctx *ctx,uint64_t a,unsigned int from,uint64_t *ret)  - a at scale from
+* return 0 if the result does not fit int64 (or b == 0)
+- int fix_dot(const struct fixctx *ctx,const uint64_t *a,const uint64_t *b,size_t n,uint64_t *ret)
+* sum of a[i]*b[i], exact, rounded only once at the end; 0 on overflow
+- int fix_parse(const struct fixctx *ctx,const char *s,const char *end,uint64_t *ret)
+* [+|-]digits[.digits] (at least one digit), extra fraction digits are rounded; returns FIX_OK/INVALID/RANGE
+
+- size_t fix_mul_batch(ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n), fix_div_batch
+- size_t fix_rescale_batch(ctx,uint64_t *dst,const uint64_t *a,unsigned int from,size_t n)
+- size_t fix_sum_checked(const uint64_t *a,size_t n,uint64_t *ret)    - int64 sum (any scale)
+* b[i*bstep]: bstep == 0 for a scalar b; return n, or the index of the first element that fails
+  (dst is written up to there)
+*/
+
+enum { FIX_TRUNC, FIX_FLOOR, FIX_CEIL, FIX_HALF_UP, FIX_HALF_EVEN }; // HALF_UP: ties away from zero
+enum { FIX_OK, FIX_INVALID, FIX_RANGE };
+
+#define FIX_MAX_SCALE 18
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct fixctx {
+  unsigned int scale;
+  int rounding;
+  uint64_t pow;        // 10^scale
+  struct modctx mod;   // Barrett constants for pow (scale > 0: pow is even)
+};
+
+static const uint64_t fix_pow10[FIX_MAX_SCALE+1] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+  1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+  1000000000000000000ULL
+};
+
+static inline void fix_init(struct fixctx *ctx,unsigned int scale,int rounding)
+{
+  ctx->scale = scale;
+  ctx->rounding = rounding;
+  ctx->pow = fix_pow10[scale];
+  mod_init(&ctx->mod, ctx->pow);
+}
+
+static inline uint64_t fix_abs(uint64_t a)
+{
+  return (a >> 63) ? 0 - a : a;
+}
+
+// q: magnitude of the truncated result, r < d: remainder; q <= 2^63
+static inline uint64_t fix_round(uint64_t q,uint64_t r,uint64_t d,int neg,int mode)
+{
+  switch (mode) {
+  case FIX_FLOOR:     return q + ( (neg)&&(r) );
+  case FIX_CEIL:      return q + ( (!neg)&&(r) );
+  case FIX_HALF_UP:   return q + (r >= d - r);
+  case FIX_HALF_EVEN: return q + ( (r > d - r)||((r == d - r)&&(q & 1)) );
+  default:            return q;
+  }
+}
+
+static inline int fix_signed(uint64_t q,int neg,uint64_t *ret)
+{
+  if (q > ((uint64_t)1 << 63) - !neg) {
+    return 0;
+  }
+  *ret = (neg) ? 0 - q : q;
+  return 1;
+}
+
+// (hi,lo) / 10^scale: returns the low quotient word, *qh the high one
+static inline uint64_t fix_divpow(const struct fixctx *ctx,uint64_t hi,uint64_t lo,uint64_t *qh,uint64_t *rem)
+{
+  if (!ctx->scale) {
+    *qh = hi;
+    *rem = 0;
+    return lo;
+  }
+  uint64_t h, l, ph;
+  mulhi128x128(hi, lo, ctx->mod.muh, ctx->mod.mul, &h, &l); // q <= floor(x/pow), at most 2 less
+  const uint64_t pl = mul64x64(l, ctx->pow, &ph);
+  ph += h * ctx->pow;
+  uint64_t rl = lo - pl, rh = hi - ph - (lo < pl);
+  while ( (rh)||(rl >= ctx->pow) ) {
+    rh -= (rl < ctx->pow);
+    rl -= ctx->pow;
+    l++;
+    h += !l;
+  }
+  *qh = h;
+  *rem = rl;
+  return l;
+}
+
+// (hi,lo) magnitude at 10^scale times the wanted result
+static inline int fix_round128(const struct fixctx *ctx,uint64_t hi,uint64_t lo,int neg,uint64_t *ret)
+{
+  uint64_t qh, r;
+  const uint64_t q = fix_divpow(ctx, hi, lo, &qh, &r);
+  if ( (qh)||(q > ((uint64_t)1 << 63)) ) {
+    return 0;
+  }
+  return fix_signed(fix_round(q, r, ctx->pow, neg, ctx->rounding), neg, ret);
+}
+
+static inline int fix_mul(const struct fixctx *ctx,uint64_t a,uint64_t b,uint64_t *ret)
+{
+  uint64_t hi;
+  const uint64_t lo = mul64x64(fix_abs(a), fix_abs(b), &hi);
+  return fix_round128(ctx, hi, lo, (int)((a ^ b) >> 63), ret);
+}
+
+static inline int fix_div(const struct fixctx *ctx,uint64_t a,uint64_t b,uint64_t *ret)
+{
+  const uint64_t d = fix_abs(b);
+  uint64_t hi, r;
+  const uint64_t lo = mul64x64(fix_abs(a), ctx->pow, &hi);
+  if ( (!d)||(hi >= d) ) {
+    return 0;
+  }
+  const uint64_t q = div128by64(hi, lo, d, &r);
+  if (q > ((uint64_t)1 << 63)) {
+    return 0;
+  }
+  const int neg = (int)((a ^ b) >> 63);
+  return fix_signed(fix_round(q, r, d, neg, ctx->rounding), neg, ret);
+}
+
+static inline int fix_rescale(const struct fixctx *ctx,uint64_t a,unsigned int from,uint64_t *ret)
+{
+  const uint64_t m = fix_abs(a);
+  const int neg = (int)(a >> 63);
+  if (from > ctx->scale) {
+    const uint64_t d = fix_pow10[from - ctx->scale];
+    return fix_signed(fix_round(m / d, m % d, d, neg, ctx->rounding), neg, ret);
+  }
+  uint64_t hi;
+  const uint64_t lo = mul64x64(m, fix_pow10[ctx->scale - from], &hi);
+  return (!hi)&&(fix_signed(lo, neg, ret));
+}
+
+static inline int fix_dot(const struct fixctx *ctx,const uint64_t *a,const uint64_t *b,size_t n,uint64_t *ret)
+{
+  uint64_t acch = 0, accl = 0; // two's complement, 128 bit
+  for (size_t i=0; i<n; i++) {
+    uint64_t ph;
+    uint64_t pl = mul64x64(fix_abs(a[i]), fix_abs(b[i]), &ph);
+    if ((a[i] ^ b[i]) >> 63) {
+      ph = ~ph + (pl == 0);
+      pl = 0 - pl;
+    }
+    accl += pl;
+    const uint64_t sum = acch + ph + (accl < pl);
+    if (((acch ^ sum) & (ph ^ sum)) >> 63) { // same signs in, other sign out
+      return 0;
+    }
+    acch = sum;
+  }
+  const int neg = (int)(acch >> 63);
+  if (neg) {
+    acch = ~acch + (accl == 0);
+    accl = 0 - accl;
+  }
+  return fix_round128(ctx, acch, accl, neg, ret);
+}
+
+// digit into the magnitude; *range set on overflow
+static inline uint64_t fix_digit(uint64_t m,unsigned int d,int *range)
+{
+  if ( (m > 1844674407370955161ULL)||((m == 1844674407370955161ULL)&&(d > 5)) ) {
+    *range = 1;
+  }
+  return m * 10 + d;
+}
+
+static inline int fix_parse(const struct fixctx *ctx,const char *s,const char *end,uint64_t *ret)
+{
+  int neg = 0, range = 0, digits = 0;
+  if ( (s!=end)&&((*s=='-')||(*s=='+')) ) {
+    neg = (*s=='-');
+    s++;
+  }
+  uint64_t m = 0;
+  for (; (s!=end)&&((unsigned int)(*s - '0') <= 9); s++, digits++) {
+    m = fix_digit(m, *s - '0', &range);
+  }
+  unsigned int frac = 0;
+  int extra = 0; // dropped fraction digits, as remainder of 4: 0, below half 1, half 2, above half 3
+  if ( (s!=end)&&(*s=='.') ) {
+    for (s++; (s!=end)&&((unsigned int)(*s - '0') <= 9); s++, digits++) {
+      const unsigned int d = *s - '0';
+      if (frac < ctx->scale) {
+        m = fix_digit(m, d, &range);
+        frac++;
+      } else if (frac++ == ctx->scale) {
+        extra = (d > 5) ? 3 : (d == 5) ? 2 : (d > 0);
+      } else if ( (d)&&(!(extra & 1)) ) {
+        extra++; // 0 -> below half, half -> above half
+      }
+    }
+  }
+  if ( (s!=end)||(!digits) ) {
+    return FIX_INVALID;
+  }
+  for (; frac < ctx->scale; frac++) {
+    m = fix_digit(m, 0, &range);
+  }
+  if ( (range)||(m > ((uint64_t)1 << 63))||
+       (!fix_signed(fix_round(m, extra, 4, neg, ctx->rounding), neg, ret)) ) {
+    return FIX_RANGE;
+  }
+  return FIX_OK;
+}
+
+static inline size_t fix_mul_batch(const struct fixctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    if (!fix_mul(ctx, a[i], b[i*bstep], &dst[i])) {
+      return i;
+    }
+  }
+  return n;
+}
+
+static inline size_t fix_div_batch(const struct fixctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    if (!fix_div(ctx, a[i], b[i*bstep], &dst[i])) {
+      return i;
+    }
+  }
+  return n;
+}
+
+static inline size_t fix_rescale_batch(const struct fixctx *ctx,uint64_t *dst,const uint64_t *a,unsigned int from,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    if (!fix_rescale(ctx, a[i], from, &dst[i])) {
+      return i;
+    }
+  }
+  return n;
+}
+
+static inline size_t fix_sum_checked(const uint64_t *a,size_t n,uint64_t *ret)
+{
+  uint64_t acc = 0;
+  for (size_t i=0; i<n; i++) {
+    const uint64_t sum = acc + a[i];
+    if (((acc ^ sum) & (a[i] ^ sum)) >> 63) {
+      *ret = acc;
+      return i;
+    }
+    acc = sum;
+  }
+  *ret = acc;
+  return n;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _LOGHIST_H
+#define _LOGHIST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "bitcount.h"
+
+/* Provides:
+
+Log-linear (HdrHistogram-like) bucketing of 64bit values:
+values < 2^sub get one bucket each, every following power of two is split into 2^(sub-1) linear sub-buckets.
+So every bucket [lowest,highest] has a relative width of at most 2^-(sub-1).   (1 <= sub <= 16)
+
+- size_t loghist_buckets(unsigned int sub)
+- size_t loghist_index(uint64_t val,unsigned int sub)
+- uint64_t loghist_lowest(size_t idx,unsigned int sub)
+- uint64_t loghist_highest(size_t idx,unsigned int sub)
+- void loghist_record_batch(uint64_t *counts,unsigned int sub,const uint64_t *vals,size_t n,uint64_t *min,uint64_t *max)
+* min/max are only updated (i.e. must be initialized by caller)
+*/
+
+#define LOGHIST_MAX_SUB 16
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline size_t loghist_buckets(unsigned int sub)
+{
+  return (size_t)(66-sub) << (sub-1);
+}
+
+static inline size_t loghist_index(uint64_t val,unsigned int sub)
+{
+  const unsigned int msb = 63 - clz64(val | (((uint64_t)1<<sub)-1)); // >= sub-1
+  const unsigned int shift = msb - (sub-1);
+  return ((size_t)shift << (sub-1)) + (size_t)(val >> shift);
+}
+
+static inline unsigned int _loghist_shift(size_t idx,unsigned int sub)
+{
+  const size_t top = idx >> (sub-1); // == shift+1, except for the first 2^sub buckets
+  return (top) ? (unsigned int)top-1 : 0;
+}
+
+static inline uint64_t loghist_lowest(size_t idx,unsigned int sub)
+{
+  const unsigned int shift = _loghist_shift(idx,sub);
+  return (uint64_t)(idx - ((size_t)shift << (sub-1))) << shift;
+}
+
+static inline uint64_t loghist_highest(size_t idx,unsigned int sub)
+{
+  return loghist_lowest(idx,sub) + (((uint64_t)1 << _loghist_shift(idx,sub)) - 1);
+}
+
+static inline void loghist_record_batch(uint64_t *counts,unsigned int sub,const uint64_t *vals,size_t n,uint64_t *min,uint64_t *max)
+{
+  uint64_t lo = *min, hi = *max;
+  for (size_t i=0; i<n; i++) {
+    const uint64_t val = vals[i];
+    counts[loghist_index(val,sub)]++;
+    lo = (val < lo) ? val : lo;
+    hi = (val > hi) ? val : hi;
+  }
+  *min = lo;
+  *max = hi;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
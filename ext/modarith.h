@@ -0,0 +1,299 @@
+#ifndef _MODARITH_H
+#define _MODARITH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "u128.h"
+
+/* Provides:
+
+Arithmetic modulo a 64bit m >= 1, without 128 bit divisions in the hot paths:
+odd m uses Montgomery multiplication (R = 2^64), even m Barrett reduction (mu = floor(2^128/m)).
+
+- void mod_init(struct modctx *ctx,uint64_t m)         - m >= 1; precomputes constants
+- uint64_t mod_reduce(const struct modctx *ctx,uint64_t a)
+- uint64_t mod_add(ctx,a,b), mod_sub(ctx,a,b), mod_mul(ctx,a,b), mod_pow(ctx,a,e)
+* arguments may be >= m; results are < m
+- int mod_inverse(const struct modctx *ctx,uint64_t a,uint64_t *ret)  - 0: gcd(a,m) != 1
+- int mod_isprime(uint64_t n)                          - deterministic (Miller-Rabin, 7 bases)
+
+- void mod_reduce_batch(ctx,uint64_t *dst,const uint64_t *a,size_t n)
+- void mod_add_batch(ctx,dst,a,b,bstep,n), mod_sub_batch, mod_mul_batch, mod_pow_batch
+* b[i*bstep]: bstep == 0 for a scalar b (mod_pow_batch: exponent)
+- void mod_inverse_batch(ctx,dst,a,n)                   - 0 where not invertible
+- void mod_isprime_batch(const uint64_t *a,size_t n,uint8_t *out)
+* out must hold (n+7)/8 bytes; bit (i&7) of out[i>>3] is set iff a[i] is prime
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct modctx {
+  uint64_t m;
+  int mont;      // m odd
+  uint64_t minv; // m^-1 mod 2^64                 (mont)
+  uint64_t one;  // 2^64 mod m, i.e. 1*R          (mont)
+  uint64_t r2;   // 2^128 mod m                   (mont)
+  uint64_t muh, mul; // floor(2^128/m)            (Barrett)
+};
+
+static inline void mod_init(struct modctx *ctx,uint64_t m)
+{
+  ctx->m = m;
+  ctx->mont = m & 1;
+  if (ctx->mont) {
+    uint64_t inv = m; // correct to 3 bits, Newton doubles that each step
+    for (int i=0; i<5; i++) {
+      inv *= 2 - m * inv;
+    }
+    ctx->minv = inv;
+    ctx->one = (0 - m) % m;
+    uint64_t hi;
+    const uint64_t lo = mul64x64(ctx->one, ctx->one, &hi);
+    ctx->r2 = mod128by64(hi, lo, m);
+    ctx->muh = ctx->mul = 0;
+  } else {
+    uint64_t qh = UINT64_MAX / m, rem = UINT64_MAX % m + 1;
+    if (rem == m) {
+      qh++;
+      rem = 0;
+    }
+    ctx->muh = qh;
+    ctx->mul = div128by64(rem, 0, m, &rem);
+    ctx->minv = ctx->one = ctx->r2 = 0;
+  }
+}
+
+// Montgomery reduction: (hi,lo) * 2^-64 mod m, requires hi < m
+static inline uint64_t mod_redc(const struct modctx *ctx,uint64_t hi,uint64_t lo)
+{
+  uint64_t uh;
+  mul64x64(lo * ctx->minv, ctx->m, &uh); // low halves cancel
+  return (hi < uh) ? hi - uh + ctx->m : hi - uh;
+}
+
+static inline uint64_t mod_tomont(const struct modctx *ctx,uint64_t a)
+{
+  uint64_t hi;
+  const uint64_t lo = mul64x64(a, ctx->r2, &hi); // < 2^64 * m
+  return mod_redc(ctx, hi, lo);
+}
+
+// (hi,lo) mod m, any value
+static inline uint64_t mod_barrett(const struct modctx *ctx,uint64_t hi,uint64_t lo)
+{
+  uint64_t qh, ql, ph;
+  mulhi128x128(hi, lo, ctx->muh, ctx->mul, &qh, &ql); // q <= floor(x/m), at most 2 less
+  const uint64_t pl = mul64x64(ql, ctx->m, &ph);
+  ph += qh * ctx->m;
+  uint64_t rl = lo - pl, rh = hi - ph - (lo < pl);
+  while ( (rh)||(rl >= ctx->m) ) {
+    rh -= (rl < ctx->m);
+    rl -= ctx->m;
+  }
+  return rl;
+}
+
+static inline uint64_t mod_reduce(const struct modctx *ctx,uint64_t a)
+{
+  return (a >= ctx->m) ? a % ctx->m : a;
+}
+
+static inline uint64_t mod_add(const struct modctx *ctx,uint64_t a,uint64_t b)
+{
+  a = mod_reduce(ctx, a);
+  b = mod_reduce(ctx, b);
+  const uint64_t ret = a + b;
+  return ( (ret < a)||(ret >= ctx->m) ) ? ret - ctx->m : ret;
+}
+
+static inline uint64_t mod_sub(const struct modctx *ctx,uint64_t a,uint64_t b)
+{
+  a = mod_reduce(ctx, a);
+  b = mod_reduce(ctx, b);
+  return (a < b) ? a - b + ctx->m : a - b;
+}
+
+static inline uint64_t mod_mul(const struct modctx *ctx,uint64_t a,uint64_t b)
+{
+  uint64_t hi, lo;
+  if (ctx->mont) { // redc(aR * b) = ab; aR < m keeps the product < 2^64 * m
+    lo = mul64x64(mod_tomont(ctx, a), b, &hi);
+    return mod_redc(ctx, hi, lo);
+  }
+  lo = mul64x64(a, b, &hi);
+  return mod_barrett(ctx, hi, lo);
+}
+
+static inline uint64_t mod_mulmont(const struct modctx *ctx,uint64_t a,uint64_t b)
+{
+  uint64_t hi;
+  const uint64_t lo = mul64x64(a, b, &hi);
+  return mod_redc(ctx, hi, lo);
+}
+
+// Montgomery form in and out
+static inline uint64_t mod_powmont(const struct modctx *ctx,uint64_t base,uint64_t e)
+{
+  uint64_t ret = ctx->one;
+  for (; e; e >>= 1) {
+    if (e & 1) {
+      ret = mod_mulmont(ctx, ret, base);
+    }
+    base = mod_mulmont(ctx, base, base);
+  }
+  return ret;
+}
+
+static inline uint64_t mod_pow(const struct modctx *ctx,uint64_t a,uint64_t e)
+{
+  if (ctx->mont) {
+    return mod_redc(ctx, 0, mod_powmont(ctx, mod_tomont(ctx, a), e));
+  }
+  uint64_t ret = mod_reduce(ctx, 1), base = mod_reduce(ctx, a);
+  for (; e; e >>= 1) {
+    if (e & 1) {
+      ret = mod_mul(ctx, ret, base);
+    }
+    base = mod_mul(ctx, base, base);
+  }
+  return ret;
+}
+
+// extended Euclid, coefficients kept mod m
+static inline int mod_inverse(const struct modctx *ctx,uint64_t a,uint64_t *ret)
+{
+  uint64_t r = ctx->m, newr = mod_reduce(ctx, a),
+           t = 0, newt = mod_reduce(ctx, 1);
+  while (newr) {
+    const uint64_t q = r / newr, tmpr = r - q * newr;
+    uint64_t hi;
+    const uint64_t lo = mul64x64(mod_reduce(ctx, q), newt, &hi);
+    const uint64_t tmpt = mod_sub(ctx, t, mod128by64(hi, lo, ctx->m));
+    r = newr;
+    newr = tmpr;
+    t = newt;
+    newt = tmpt;
+  }
+  *ret = t;
+  return r == 1;
+}
+
+static inline int mod_isprime(uint64_t n)
+{
+  static const uint8_t small[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  // deterministic for n < 2^64 (Jim Sinclair)
+  static const uint64_t bases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+  if (n < 2) {
+    return 0;
+  }
+  for (size_t i=0; i<sizeof(small); i++) {
+    if (n % small[i] == 0) {
+      return n == small[i];
+    }
+  }
+  if (n < 41*41) {
+    return 1;
+  }
+
+  struct modctx ctx;
+  mod_init(&ctx, n);
+  uint64_t d = n - 1;
+  int s = 0;
+  while (!(d & 1)) {
+    d >>= 1;
+    s++;
+  }
+  const uint64_t mone = n - ctx.one; // -1 in Montgomery form
+  for (size_t i=0; i<sizeof(bases)/sizeof(*bases); i++) {
+    const uint64_t a = bases[i] % n;
+    if (!a) {
+      continue;
+    }
+    uint64_t x = mod_powmont(&ctx, mod_tomont(&ctx, a), d);
+    if ( (x == ctx.one)||(x == mone) ) {
+      continue;
+    }
+    int j;
+    for (j=1; j<s; j++) {
+      x = mod_mulmont(&ctx, x, x);
+      if (x == mone) {
+        break;
+      }
+    }
+    if (j == s) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static inline void mod_reduce_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    dst[i] = mod_reduce(ctx, a[i]);
+  }
+}
+
+static inline void mod_add_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    dst[i] = mod_add(ctx, a[i], b[i*bstep]);
+  }
+}
+
+static inline void mod_sub_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    dst[i] = mod_sub(ctx, a[i], b[i*bstep]);
+  }
+}
+
+static inline void mod_mul_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *b,size_t bstep,size_t n)
+{
+  if ( (ctx->mont)&&(!bstep) ) { // b in Montgomery form once: one multiplication + redc per element
+    const uint64_t bm = mod_tomont(ctx, *b);
+    for (size_t i=0; i<n; i++) {
+      dst[i] = mod_mulmont(ctx, a[i], bm);
+    }
+    return;
+  }
+  for (size_t i=0; i<n; i++) {
+    dst[i] = mod_mul(ctx, a[i], b[i*bstep]);
+  }
+}
+
+static inline void mod_pow_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,const uint64_t *e,size_t estep,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    dst[i] = mod_pow(ctx, a[i], e[i*estep]);
+  }
+}
+
+static inline void mod_inverse_batch(const struct modctx *ctx,uint64_t *dst,const uint64_t *a,size_t n)
+{
+  for (size_t i=0; i<n; i++) {
+    if (!mod_inverse(ctx, a[i], &dst[i])) {
+      dst[i] = 0;
+    }
+  }
+}
+
+static inline void mod_isprime_batch(const uint64_t *a,size_t n,uint8_t *out)
+{
+  for (size_t i=0; i<n; i+=8) {
+    const size_t m = (n-i < 8) ? n-i : 8;
+    unsigned int bits = 0;
+    for (size_t j=0; j<m; j++) {
+      bits |= mod_isprime(a[i+j]) << j;
+    }
+    out[i>>3] = bits;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
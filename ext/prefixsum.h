@@ -0,0 +1,174 @@
+#ifndef _PREFIXSUM_H
+#define _PREFIXSUM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Provides:
+
+Prefix sums (wrapping mod 2^64); dst may equal src; acc: initial value, returns the running sum
+- uint64_t scan_inclusive(uint64_t *dst,const uint64_t *src,size_t n,uint64_t acc)  - dst[i] = acc + src[0..i]
+- uint64_t scan_exclusive(uint64_t *dst,const uint64_t *src,size_t n,uint64_t acc)  - dst[i] = acc + src[0..i-1]
+- uint64_t scan_sum(const uint64_t *src,size_t n)
+
+Overflow-checked: return n, or the index at which the sum first exceeds 2^64-1 (dst written up to there)
+- size_t scan_inclusive_checked(uint64_t *dst,const uint64_t *src,size_t n,uint64_t *acc)
+- size_t scan_exclusive_checked(uint64_t *dst,const uint64_t *src,size_t n,uint64_t *acc)
+- size_t scan_sum_checked(const uint64_t *src,size_t n,uint64_t *acc)
+
+Segmented: a set bit (pos+i)&7 in heads[(pos+i)>>3] starts a new segment at i (the sum restarts at 0)
+- uint64_t scan_segmented(uint64_t *dst,const uint64_t *src,size_t n,const uint8_t *heads,size_t pos,uint64_t acc,int exclusive)
+- uint64_t scan_segmented_tail(const uint64_t *src,size_t n,const uint8_t *heads,size_t pos,int *hasHead)
+* sum after the last head (or of all, if none); for the carry between blocks
+
+Histograms: add to counts (not cleared)
+- void hist_bits(uint64_t *counts,const uint64_t *src,size_t n,unsigned int shift,uint64_t mask)
+* counts[(src[i] >> shift) & mask]++
+- void hist_bounds(uint64_t *counts,const uint64_t *src,size_t n,const uint64_t *bounds,size_t m)
+* bounds sorted ascending; counts[k]++ for bounds[k-1] <= src[i] < bounds[k], i.e. m+1 buckets
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint64_t scan_inclusive(uint64_t *dst,const uint64_t *src,size_t n,uint64_t acc)
+{
+  for (size_t i=0; i<n; i++) {
+    acc += src[i];
+    dst[i] = acc;
+  }
+  return acc;
+}
+
+static inline uint64_t scan_exclusive(uint64_t *dst,const uint64_t *src,size_t n,uint64_t acc)
+{
+  for (size_t i=0; i<n; i++) {
+    const uint64_t val = src[i];
+    dst[i] = acc;
+    acc += val;
+  }
+  return acc;
+}
+
+static inline uint64_t scan_sum(const uint64_t *src,size_t n)
+{
+  uint64_t acc = 0;
+  for (size_t i=0; i<n; i++) {
+    acc += src[i];
+  }
+  return acc;
+}
+
+static inline size_t scan_inclusive_checked(uint64_t *dst,const uint64_t *src,size_t n,uint64_t *acc)
+{
+  uint64_t sum = *acc;
+  for (size_t i=0; i<n; i++) {
+    const uint64_t next = sum + src[i];
+    if (next < sum) {
+      *acc = sum;
+      return i;
+    }
+    dst[i] = sum = next;
+  }
+  *acc = sum;
+  return n;
+}
+
+static inline size_t scan_exclusive_checked(uint64_t *dst,const uint64_t *src,size_t n,uint64_t *acc)
+{
+  uint64_t sum = *acc;
+  for (size_t i=0; i<n; i++) {
+    const uint64_t next = sum + src[i];
+    if (next < sum) {
+      *acc = sum;
+      return i;
+    }
+    dst[i] = sum;
+    sum = next;
+  }
+  *acc = sum;
+  return n;
+}
+
+static inline size_t scan_sum_checked(const uint64_t *src,size_t n,uint64_t *acc)
+{
+  uint64_t sum = *acc;
+  for (size_t i=0; i<n; i++) {
+    const uint64_t next = sum + src[i];
+    if (next < sum) {
+      *acc = sum;
+      return i;
+    }
+    sum = next;
+  }
+  *acc = sum;
+  return n;
+}
+
+#define _PREFIXSUM_HEAD(heads,i) ((heads[(i)>>3] >> ((i)&7)) & 1)
+
+static inline uint64_t scan_segmented(uint64_t *dst,const uint64_t *src,size_t n,const uint8_t *heads,size_t pos,uint64_t acc,int exclusive)
+{
+  for (size_t i=0; i<n; i++) {
+    const uint64_t val = src[i];
+    if (_PREFIXSUM_HEAD(heads, pos+i)) {
+      acc = 0;
+    }
+    if (exclusive) {
+      dst[i] = acc;
+      acc += val;
+    } else {
+      acc += val;
+      dst[i] = acc;
+    }
+  }
+  return acc;
+}
+
+static inline uint64_t scan_segmented_tail(const uint64_t *src,size_t n,const uint8_t *heads,size_t pos,int *hasHead)
+{
+  uint64_t acc = 0;
+  *hasHead = 0;
+  for (size_t i=0; i<n; i++) {
+    if (_PREFIXSUM_HEAD(heads, pos+i)) {
+      acc = 0;
+      *hasHead = 1;
+    }
+    acc += src[i];
+  }
+  return acc;
+}
+
+#undef _PREFIXSUM_HEAD
+
+static inline void hist_bits(uint64_t *counts,const uint64_t *src,size_t n,unsigned int shift,uint64_t mask)
+{
+  for (size_t i=0; i<n; i++) {
+    counts[(src[i] >> shift) & mask]++;
+  }
+}
+
+static inline void hist_bounds(uint64_t *counts,const uint64_t *src,size_t n,const uint64_t *bounds,size_t m)
+{
+  for (size_t i=0; i<n; i++) {
+    const uint64_t val = src[i];
+    size_t lo = 0, len = m; // upper_bound
+    while (len > 0) {
+      const size_t half = len >> 1;
+      if (bounds[lo + half] <= val) {
+        lo += half + 1;
+        len -= half + 1;
+      } else {
+        len = half;
+      }
+    }
+    counts[lo]++;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef _RECORDS_H
+#define _RECORDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "bitops.h"
+
+/* Provides:
+
+Integer fields of fixed-size binary records (e.g. network frames) to/from packed u64 columns.
+
+- struct recfield { size_t offset; unsigned int bytes; int flags; }
+* bytes: 1, 2, 4 or 8; flags: REC_SIGNED (sign-extend narrow fields), REC_BIGENDIAN
+- void rec_gather(uint64_t *dst,const uint8_t *src,size_t stride,size_t n,const struct recfield *f)
+* dst[i] = field f of record i (at src + i*stride + f->offset), zero- or sign-extended
+- void rec_scatter(uint8_t *dst,const uint64_t *src,size_t stride,size_t n,const struct recfield *f)
+* stores the low f->bytes of src[i]; the other bytes of the records are left unchanged
+- void rec_gather_all(uint64_t **cols,const uint8_t *src,size_t stride,size_t n,const struct recfield *fs,size_t nfields)
+- void rec_scatter_all(uint8_t *dst,uint64_t *const *cols,size_t stride,size_t n,const struct recfield *fs,size_t nfields)
+* all fields, REC_BLOCK records at a time: each record comes from memory once, not once per field;
+  cols[j] == NULL skips field j
+* records need not be aligned; the caller checks offset + bytes <= stride
+*/
+
+#define REC_SIGNED    1
+#define REC_BIGENDIAN 2
+
+#define REC_BLOCK 256 // records per block in rec_*_all (stays in L1 for typical strides)
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define REC_HOST_BIGENDIAN REC_BIGENDIAN
+#else
+#define REC_HOST_BIGENDIAN 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct recfield {
+  size_t offset;
+  unsigned int bytes;
+  int flags;
+};
+
+// one loop per width/byte order/sign, so the conversion is not decided per record
+#define _RECORDS_H_GATHER(type,stype,swap) \
+  for (size_t i=0; i<n; i++, src+=stride) { \
+    type val;                                     \
+    memcpy(&val, src, sizeof(val));               \
+    if (swap) {                                   \
+      val = (type)(bswap64(val) >> (64 - 8*sizeof(type))); \
+    }                                             \
+    dst[i] = (sign) ? (uint64_t)(int64_t)(stype)val : (uint64_t)val; \
+  }                                               \
+  break;
+
+#define _RECORDS_H_SCATTER(type,swap) \
+  for (size_t i=0; i<n; i++, dst+=stride) { \
+    type val = (type)src[i];                      \
+    if (swap) {                                   \
+      val = (type)(bswap64(val) >> (64 - 8*sizeof(type))); \
+    }                                             \
+    memcpy(dst, &val, sizeof(val));               \
+  }                                               \
+  break;
+
+static inline void rec_gather(uint64_t *dst,const uint8_t *src,size_t stride,size_t n,const struct recfield *f)
+{
+  const int swap = (f->flags & REC_BIGENDIAN) != REC_HOST_BIGENDIAN,
+            sign = f->flags & REC_SIGNED;
+  src += f->offset;
+  switch (f->bytes * 2 + swap) {
+  case 2:  _RECORDS_H_GATHER(uint8_t, int8_t, 0)
+  case 3:  _RECORDS_H_GATHER(uint8_t, int8_t, 0)
+  case 4:  _RECORDS_H_GATHER(uint16_t, int16_t, 0)
+  case 5:  _RECORDS_H_GATHER(uint16_t, int16_t, 1)
+  case 8:  _RECORDS_H_GATHER(uint32_t, int32_t, 0)
+  case 9:  _RECORDS_H_GATHER(uint32_t, int32_t, 1)
+  case 16: _RECORDS_H_GATHER(uint64_t, int64_t, 0)
+  case 17: _RECORDS_H_GATHER(uint64_t, int64_t, 1)
+  }
+}
+
+static inline void rec_scatter(uint8_t *dst,const uint64_t *src,size_t stride,size_t n,const struct recfield *f)
+{
+  const int swap = (f->flags & REC_BIGENDIAN) != REC_HOST_BIGENDIAN;
+  dst += f->offset;
+  switch (f->bytes * 2 + swap) {
+  case 2:  _RECORDS_H_SCATTER(uint8_t, 0)
+  case 3:  _RECORDS_H_SCATTER(uint8_t, 0)
+  case 4:  _RECORDS_H_SCATTER(uint16_t, 0)
+  case 5:  _RECORDS_H_SCATTER(uint16_t, 1)
+  case 8:  _RECORDS_H_SCATTER(uint32_t, 0)
+  case 9:  _RECORDS_H_SCATTER(uint32_t, 1)
+  case 16: _RECORDS_H_SCATTER(uint64_t, 0)
+  case 17: _RECORDS_H_SCATTER(uint64_t, 1)
+  }
+}
+
+#undef _RECORDS_H_GATHER
+#undef _RECORDS_H_SCATTER
+
+static inline void rec_gather_all(uint64_t **cols,const uint8_t *src,size_t stride,size_t n,const struct recfield *fs,size_t nfields)
+{
+  for (size_t i=0; i<n; i+=REC_BLOCK) {
+    const size_t m = (n-i < REC_BLOCK) ? n-i : REC_BLOCK;
+    for (size_t j=0; j<nfields; j++) {
+      if (cols[j]) {
+        rec_gather(cols[j] + i, src + i*stride, stride, m, &fs[j]);
+      }
+    }
+  }
+}
+
+static inline void rec_scatter_all(uint8_t *dst,uint64_t *const *cols,size_t stride,size_t n,const struct recfield *fs,size_t nfields)
+{
+  for (size_t i=0; i<n; i+=REC_BLOCK) {
+    const size_t m = (n-i < REC_BLOCK) ? n-i : REC_BLOCK;
+    for (size_t j=0; j<nfields; j++) {
+      if (cols[j]) {
+        rec_scatter(dst + i*stride, cols[j] + i, stride, m, &fs[j]);
+      }
+    }
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
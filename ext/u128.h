@@ -0,0 +1,104 @@
+#ifndef _U128_H
+#define _U128_H
+
+#include <stdint.h>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/* Provides:
+
+128 bit arithmetic on (hi,lo) pairs of uint64_t
+- uint64_t mul64x64(uint64_t a,uint64_t b,uint64_t *hi)        - returns lo
+- uint64_t div128by64(uint64_t hi,uint64_t lo,uint64_t d,uint64_t *rem)  - requires hi < d (quotient fits 64 bits)
+- uint64_t mod128by64(uint64_t hi,uint64_t lo,uint64_t d)      - any hi
+- void mulhi128x128(uint64_t ah,uint64_t al,uint64_t bh,uint64_t bl,uint64_t *hi,uint64_t *lo)
+* upper 128 bits of the 256 bit product
+
+* uses unsigned __int128 (gcc, clang on 64bit) or _umul128 (MSVC x64), else portable 32bit pieces;
+  div128by64: divq on x86-64 (gcc, clang), else __int128 or bitwise (slow: for precomputation)
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline uint64_t mul64x64(uint64_t a,uint64_t b,uint64_t *hi)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 ret = (unsigned __int128)a * b;
+  *hi = (uint64_t)(ret >> 64);
+  return (uint64_t)ret;
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return _umul128(a, b, hi);
+#else
+  const uint64_t al = (uint32_t)a, ah = a >> 32,
+                 bl = (uint32_t)b, bh = b >> 32;
+  const uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+  const uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+  *hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+  return (mid << 32) | (uint32_t)ll;
+#endif
+}
+
+static inline uint64_t div128by64(uint64_t hi,uint64_t lo,uint64_t d,uint64_t *rem)
+{
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  uint64_t q; // hi < d: no #DE; __int128 division would call __udivti3
+  __asm__("divq %4" : "=a"(q), "=d"(*rem) : "a"(lo), "d"(hi), "rm"(d));
+  return q;
+#elif defined(__SIZEOF_INT128__)
+  const unsigned __int128 n = ((unsigned __int128)hi << 64) | lo;
+  *rem = (uint64_t)(n % d);
+  return (uint64_t)(n / d);
+#else
+  // restoring division, one bit per step (only used for precomputation)
+  uint64_t q = 0;
+  for (int i=0; i<64; i++) {
+    const uint64_t top = hi >> 63;
+    hi = (hi << 1) | (lo >> 63);
+    lo <<= 1;
+    q <<= 1;
+    if ( (top)||(hi >= d) ) {
+      hi -= d;
+      q |= 1;
+    }
+  }
+  *rem = hi;
+  return q;
+#endif
+}
+
+static inline uint64_t mod128by64(uint64_t hi,uint64_t lo,uint64_t d)
+{
+  uint64_t rem;
+  div128by64(hi % d, lo, d, &rem);
+  return rem;
+}
+
+static inline void mulhi128x128(uint64_t ah,uint64_t al,uint64_t bh,uint64_t bl,uint64_t *hi,uint64_t *lo)
+{
+  uint64_t llh, lhh, hlh, hhh;
+  mul64x64(al, bl, &llh);
+  const uint64_t lhl = mul64x64(al, bh, &lhh),
+                 hll = mul64x64(ah, bl, &hlh),
+                 hhl = mul64x64(ah, bh, &hhh);
+  // bits 64..127: llh + lhl + hll, carries into bits 128..
+  uint64_t mid = llh + lhl, carry = (mid < lhl);
+  mid += hll;
+  carry += (mid < hll);
+  uint64_t rl = hhl + lhh;
+  uint64_t rh = hhh + (rl < lhh);
+  rl += hlh;
+  rh += (rl < hlh);
+  rl += carry;
+  rh += (rl < carry);
+  *hi = rh;
+  *lo = rl;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
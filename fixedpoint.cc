@@ -0,0 +1,272 @@
+#include "fixedpoint.h"
+#include "addondata.h"
+#include "uint64.h"
+#include "column.h"
+#include "u64str.h"
+#include <string.h>
+#include <stdio.h>
+
+// indexed by FIX_*
+static const char *const roundingNames[] = { "trunc", "floor", "ceil", "halfUp", "halfEven" };
+
+NAN_MODULE_INIT(FixedPoint::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("FixedPoint").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->fixedPointTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("scale").ToLocalChecked(), GetScale);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("rounding").ToLocalChecked(), GetRounding);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("unit").ToLocalChecked(), GetUnit);
+
+  Nan::SetPrototypeMethod(tpl, "parse", Parse);
+  Nan::SetPrototypeMethod(tpl, "format", Format);
+  Nan::SetPrototypeMethod(tpl, "rescale", Rescale);
+  Nan::SetPrototypeMethod(tpl, "rescaleBatch", RescaleBatch);
+#define X(name,fn) \
+  Nan::SetPrototypeMethod(tpl, #name, name); \
+  Nan::SetPrototypeMethod(tpl, #name "Batch", name ## Batch);
+  FIXEDPOINT_BINARY_OPS
+#undef X
+  Nan::SetPrototypeMethod(tpl, "sum", Sum);
+  Nan::SetPrototypeMethod(tpl, "dot", Dot);
+
+  Nan::Set(target, Nan::New("FixedPoint").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+FixedPoint *FixedPoint::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->fixedPointTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad FixedPoint object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<FixedPoint>(info.Holder());
+}
+
+bool FixedPoint::ScaleArgument(v8::Local<v8::Value> arg,unsigned int &ret)
+{
+  if (!arg->IsNumber()) {
+    Nan::ThrowTypeError("Expected Number as scale");
+    return false;
+  }
+  const double scale = arg->NumberValue();
+  if ( (!(scale >= 0))||(scale > FIX_MAX_SCALE)||(scale != (unsigned int)scale) ) {
+    Nan::ThrowRangeError("Scale must be an integer between 0 and 18");
+    return false;
+  }
+  ret = (unsigned int)scale;
+  return true;
+}
+
+NAN_METHOD(FixedPoint::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("FixedPoint must be called with new");
+    return;
+  }
+  unsigned int scale;
+  if (!ScaleArgument(info[0],scale)) {
+    return;
+  }
+  int rounding = FIX_HALF_EVEN;
+  if (!info[1]->IsUndefined()) {
+    if (!info[1]->IsString()) {
+      Nan::ThrowTypeError("Expected String as rounding");
+      return;
+    }
+    Nan::Utf8String name(info[1]);
+    for (rounding=0; rounding<(int)(sizeof(roundingNames)/sizeof(*roundingNames)); rounding++) {
+      if (!strcmp(*name, roundingNames[rounding])) {
+        break;
+      }
+    }
+    if (rounding == (int)(sizeof(roundingNames)/sizeof(*roundingNames))) {
+      Nan::ThrowRangeError("Rounding must be one of trunc, floor, ceil, halfUp, halfEven");
+      return;
+    }
+  }
+
+  FixedPoint *obj = new FixedPoint(scale, rounding);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(FixedPoint::GetScale)
+{
+  FixedPoint *obj = Nan::ObjectWrap::Unwrap<FixedPoint>(info.Holder());
+  info.GetReturnValue().Set(obj->ctx.scale);
+}
+
+NAN_GETTER(FixedPoint::GetRounding)
+{
+  FixedPoint *obj = Nan::ObjectWrap::Unwrap<FixedPoint>(info.Holder());
+  info.GetReturnValue().Set(Nan::New(roundingNames[obj->ctx.rounding]).ToLocalChecked());
+}
+
+NAN_GETTER(FixedPoint::GetUnit)
+{
+  FixedPoint *obj = Nan::ObjectWrap::Unwrap<FixedPoint>(info.Holder());
+  info.GetReturnValue().Set(UInt64::NewInstance(obj->ctx.pow, true));
+}
+
+NAN_METHOD(FixedPoint::Parse)
+{
+  FixedPoint *obj = This(info);
+  if (!obj) {
+    return;
+  } else if (!info[0]->IsString()) {
+    Nan::ThrowTypeError("Expected String as argument");
+    return;
+  }
+  uint64_t ret;
+  const int res = UInt64::ParseBytes(info[0].As<v8::String>(), [&](const char *s,const char *end) {
+    return fix_parse(&obj->ctx, s, end, &ret);
+  });
+  switch (res) {
+  case FIX_OK:
+    UInt64::SetResult(info, 1, ret, true);
+    break;
+  case FIX_RANGE:
+    Nan::ThrowRangeError("Decimal out of range for this scale");
+    break;
+  default:
+    Nan::ThrowError("Invalid decimal number");
+    break;
+  }
+}
+
+NAN_METHOD(FixedPoint::Format)
+{
+  FixedPoint *obj = This(info);
+  uint64_t a;
+  if ( (!obj)||(!UInt64::FromArgument(info[0],a,true)) ) {
+    return;
+  }
+  const uint64_t m = fix_abs(a);
+  char buf[48], scratch65[65], *pos = buf; // sign, 19 digits, '.', 18 digits
+  if (a >> 63) {
+    *pos++ = '-';
+  }
+  const char *s = u64ToString(m / obj->ctx.pow, 10, scratch65);
+  size_t len = strlen(s);
+  memcpy(pos, s, len);
+  pos += len;
+  if (obj->ctx.scale) { // pow + fraction: '1' and exactly scale digits, with leading zeros
+    s = u64ToString(obj->ctx.pow + m % obj->ctx.pow, 10, scratch65) + 1;
+    *pos++ = '.';
+    memcpy(pos, s, obj->ctx.scale);
+    pos += obj->ctx.scale;
+  }
+  info.GetReturnValue().Set(Nan::New(buf, (int)(pos - buf)).ToLocalChecked());
+}
+
+NAN_METHOD(FixedPoint::Rescale)
+{
+  FixedPoint *obj = This(info);
+  uint64_t a, ret;
+  unsigned int from;
+  if ( (!obj)||(!UInt64::FromArgument(info[0],a,true))||(!ScaleArgument(info[1],from)) ) {
+    return;
+  } else if (!fix_rescale(&obj->ctx, a, from, &ret)) {
+    Nan::ThrowRangeError("Result out of range");
+    return;
+  }
+  UInt64::SetResult(info, 2, ret, true);
+}
+
+static void ThrowAt(const char *what,size_t pos)
+{
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%s at index %lu", what, (unsigned long)pos);
+  Nan::ThrowRangeError(msg);
+}
+
+NAN_METHOD(FixedPoint::RescaleBatch)
+{
+  FixedPoint *obj = This(info);
+  U64Column src, dst;
+  unsigned int from;
+  if ( (!obj)||(!U64Column::FromArgument(info[0],src))||(!ScaleArgument(info[1],from))||
+       (!U64Column::DstArgument(info,2,src,dst)) ) {
+    return;
+  }
+  const size_t pos = fix_rescale_batch(&obj->ctx, dst.data, src.data, from, src.length);
+  if (pos < src.length) {
+    ThrowAt("Result out of range", pos);
+    return;
+  }
+  info.GetReturnValue().Set((info[2]->IsUndefined()) ? info[0] : info[2]);
+}
+
+#define X(name,fn) \
+  NAN_METHOD(FixedPoint::name)                  \
+  {                                             \
+    FixedPoint *obj = This(info);               \
+    uint64_t a, b, ret;                         \
+    if ( (!obj)||(!UInt64::FromArgument(info[0],a,true))||(!UInt64::FromArgument(info[1],b,true)) ) { \
+      return;                                   \
+    } else if (!fn(&obj->ctx, a, b, &ret)) {    \
+      Nan::ThrowRangeError(b ? "Result out of range" : "Division by zero"); \
+      return;                                   \
+    }                                           \
+    UInt64::SetResult(info, 2, ret, true);      \
+  }
+FIXEDPOINT_BINARY_OPS
+#undef X
+
+#define X(name,fn) \
+  NAN_METHOD(FixedPoint::name ## Batch)         \
+  {                                             \
+    FixedPoint *obj = This(info);               \
+    U64Column src, dst;                         \
+    uint64_t scalar;                            \
+    const uint64_t *b;                          \
+    size_t step;                                \
+    if ( (!obj)||(!U64Column::FromArgument(info[0],src))||             \
+         (!U64Column::OperandArgument(info[1],src.length,scalar,b,step,true))|| \
+         (!U64Column::DstArgument(info,2,src,dst)) ) {                 \
+      return;                                   \
+    }                                           \
+    const size_t pos = fn ## _batch(&obj->ctx, dst.data, src.data, b, step, src.length); \
+    if (pos < src.length) {                     \
+      ThrowAt(b[pos*step] ? "Result out of range" : "Division by zero", pos); \
+      return;                                   \
+    }                                           \
+    info.GetReturnValue().Set((info[2]->IsUndefined()) ? info[0] : info[2]); \
+  }
+FIXEDPOINT_BINARY_OPS
+#undef X
+
+NAN_METHOD(FixedPoint::Sum)
+{
+  FixedPoint *obj = This(info);
+  U64Column src;
+  uint64_t ret;
+  if ( (!obj)||(!U64Column::FromArgument(info[0],src)) ) {
+    return;
+  }
+  const size_t pos = fix_sum_checked(src.data, src.length, &ret);
+  if (pos < src.length) {
+    ThrowAt("Sum overflows", pos);
+    return;
+  }
+  UInt64::SetResult(info, 1, ret, true);
+}
+
+NAN_METHOD(FixedPoint::Dot)
+{
+  FixedPoint *obj = This(info);
+  U64Column a, b;
+  uint64_t ret;
+  if ( (!obj)||(!U64Column::FromArgument(info[0],a))||(!U64Column::FromArgument(info[1],b)) ) {
+    return;
+  } else if (b.length < a.length) {
+    Nan::ThrowRangeError("Operand column too short");
+    return;
+  } else if (!fix_dot(&obj->ctx, a.data, b.data, a.length, &ret)) {
+    Nan::ThrowRangeError("Result out of range");
+    return;
+  }
+  UInt64::SetResult(info, 2, ret, true);
+}
@@ -0,0 +1,62 @@
+#ifndef _FIXEDPOINT_H
+#define _FIXEDPOINT_H
+
+#include <nan.h>
+#include "ext/fixed64.h"
+
+/* Provides: decimal fixed point on Int64 with a fixed scale (cf. ext/fixed64.h)
+  values: Int64 (or Number, String, BigInt) holding x*10^scale; results are Int64, written into out, if given;
+  RangeError, if a result does not fit int64
+
+new u64.FixedPoint(scale[,rounding='halfEven'])  - scale 0..18
+* rounding: 'trunc', 'floor', 'ceil', 'halfUp' (ties away from zero), 'halfEven'
+.scale:Number, .rounding:String, .unit:Int64 (10^scale, i.e. 1.0)
+.parse(str[,out])          - e.g. '-12.345'; fraction digits beyond scale are rounded
+.format(a):String          - always scale fraction digits, e.g. '-12.35' for scale 2
+.mul(a,b[,out])            - a*b / 10^scale, 128 bit intermediate, rounded once
+.div(a,b[,out])            - a*10^scale / b; RangeError also for b == 0
+.rescale(a,from[,out])     - a at scale from (0..18) to this scale
+
+.mulBatch(src,b[,dst]), .divBatch(src,b[,dst])   - b: column (elementwise) or single value
+.rescaleBatch(src,from[,dst])
+* packed u64 columns of int64 (cf. column.h), dst defaults to src;
+  a RangeError names the first failing index, dst is written up to there
+.sum(src[,out])            - int64 sum, RangeError on overflow
+.dot(a,b[,out])            - sum of a[i]*b[i], exact, divided by 10^scale and rounded once
+*/
+
+// name, fix_* function
+#define FIXEDPOINT_BINARY_OPS \
+  X(mul, fix_mul) \
+  X(div, fix_div)
+
+class FixedPoint : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  FixedPoint(unsigned int scale,int rounding) { fix_init(&ctx, scale, rounding); }
+
+  struct fixctx ctx;
+
+  static FixedPoint *This(Nan::NAN_METHOD_ARGS_TYPE info);
+  static bool ScaleArgument(v8::Local<v8::Value> arg,unsigned int &ret);
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetScale);
+  static NAN_GETTER(GetRounding);
+  static NAN_GETTER(GetUnit);
+
+  static NAN_METHOD(Parse);
+  static NAN_METHOD(Format);
+  static NAN_METHOD(Rescale);
+  static NAN_METHOD(RescaleBatch);
+#define X(name,fn) \
+  static NAN_METHOD(name); \
+  static NAN_METHOD(name ## Batch);
+  FIXEDPOINT_BINARY_OPS
+#undef X
+  static NAN_METHOD(Sum);
+  static NAN_METHOD(Dot);
+};
+
+#endif
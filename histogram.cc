@@ -0,0 +1,309 @@
+#include "histogram.h"
+#include "addondata.h"
+#include "uint64.h"
+#include "column.h"
+#include "kernels.h"
+#include "ext/loghist.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+NAN_MODULE_INIT(Histogram::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("Histogram").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->histogramTmpl.Reset(tpl);
+
+  Nan::SetMethod(tpl, "deserialize", Deserialize);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("totalCount").ToLocalChecked(), GetTotalCount);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("min").ToLocalChecked(), GetMin);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("max").ToLocalChecked(), GetMax);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("subBucketBits").ToLocalChecked(), GetSubBucketBits);
+
+  Nan::SetPrototypeMethod(tpl, "record", Record);
+  Nan::SetPrototypeMethod(tpl, "recordBatch", RecordBatch);
+  Nan::SetPrototypeMethod(tpl, "percentile", Percentile);
+  Nan::SetPrototypeMethod(tpl, "merge", Merge);
+  Nan::SetPrototypeMethod(tpl, "reset", ResetMethod);
+  Nan::SetPrototypeMethod(tpl, "serialize", Serialize);
+
+  AddonData::Get()->histogramConstructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
+  Nan::Set(target, Nan::New("Histogram").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+Histogram::Histogram(unsigned int sub)
+  : sub(sub), counts(loghist_buckets(sub))
+{
+  Reset();
+}
+
+void Histogram::Reset()
+{
+  std::fill(counts.begin(), counts.end(), 0);
+  total = 0;
+  min = ~(uint64_t)0;
+  max = 0;
+}
+
+Histogram *Histogram::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->histogramTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad Histogram object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<Histogram>(info.Holder());
+}
+
+NAN_METHOD(Histogram::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("Histogram must be called with new");
+    return;
+  }
+  int sub = 8;
+  if (!info[0]->IsUndefined()) {
+    if (!info[0]->IsInt32()) {
+      Nan::ThrowTypeError("Expected Integer as first argument");
+      return;
+    }
+    sub = info[0]->Int32Value();
+  }
+  if ( (sub<1)||(sub>LOGHIST_MAX_SUB) ) {
+    Nan::ThrowRangeError("subBucketBits must be between 1 and 16");
+    return;
+  }
+
+  Histogram *obj = new Histogram(sub);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+#define RET(val) info.GetReturnValue().Set(val); return;
+
+NAN_GETTER(Histogram::GetTotalCount)
+{
+  Histogram *obj = Nan::ObjectWrap::Unwrap<Histogram>(info.Holder());
+  RET((double)obj->total);
+}
+
+NAN_GETTER(Histogram::GetMin)
+{
+  Histogram *obj = Nan::ObjectWrap::Unwrap<Histogram>(info.Holder());
+  RET(UInt64::NewInstance((obj->total) ? obj->min : 0));
+}
+
+NAN_GETTER(Histogram::GetMax)
+{
+  Histogram *obj = Nan::ObjectWrap::Unwrap<Histogram>(info.Holder());
+  RET(UInt64::NewInstance(obj->max));
+}
+
+NAN_GETTER(Histogram::GetSubBucketBits)
+{
+  Histogram *obj = Nan::ObjectWrap::Unwrap<Histogram>(info.Holder());
+  RET(obj->sub);
+}
+
+NAN_METHOD(Histogram::Record)
+{
+  Histogram *obj = This(info);
+  uint64_t val, count = 1;
+  if ( (!obj)||(!UInt64::FromArgument(info[0],val)) ) {
+    return;
+  } else if ( (!info[1]->IsUndefined())&&(!UInt64::FromArgument(info[1],count)) ) {
+    return;
+  }
+  obj->counts[loghist_index(val, obj->sub)] += count;
+  obj->total += count;
+  if (count) {
+    if (val < obj->min) obj->min = val;
+    if (val > obj->max) obj->max = val;
+  }
+}
+
+NAN_METHOD(Histogram::RecordBatch)
+{
+  Histogram *obj = This(info);
+  U64Column vals;
+  if ( (obj)&&(U64Column::FromArgument(info[0],vals)) ) {
+    u64k->loghist_record_batch(&obj->counts[0], obj->sub, vals.data, vals.length, &obj->min, &obj->max);
+    obj->total += vals.length;
+  }
+}
+
+NAN_METHOD(Histogram::Percentile)
+{
+  Histogram *obj = This(info);
+  if (!obj) {
+    return;
+  } else if (!info[0]->IsNumber()) {
+    Nan::ThrowTypeError("Expected Number as argument");
+    return;
+  }
+  const double p = info[0]->NumberValue();
+  if (!( (p>=0)&&(p<=100) )) {
+    Nan::ThrowRangeError("Percentile must be between 0 and 100");
+    return;
+  }
+  if (!obj->total) {
+    RET(UInt64::NewInstance(0));
+  } else if (p == 0) {
+    RET(UInt64::NewInstance(obj->min));
+  }
+
+  uint64_t rank = (uint64_t)ceil(p / 100 * (double)obj->total);
+  if (rank < 1) {
+    rank = 1;
+  } else if (rank > obj->total) { // rounding
+    rank = obj->total;
+  }
+  uint64_t seen = 0;
+  size_t idx = 0;
+  for (; idx < obj->counts.size(); idx++) {
+    seen += obj->counts[idx];
+    if (seen >= rank) {
+      break;
+    }
+  }
+  const uint64_t ret = loghist_highest(idx, obj->sub);
+  RET(UInt64::NewInstance((ret < obj->max) ? ret : obj->max));
+}
+
+NAN_METHOD(Histogram::Merge)
+{
+  Histogram *obj = This(info);
+  if (!obj) {
+    return;
+  } else if (!Nan::New(AddonData::Get()->histogramTmpl)->HasInstance(info[0])) {
+    Nan::ThrowTypeError("Expected Histogram as argument");
+    return;
+  }
+  Histogram *other = Nan::ObjectWrap::Unwrap<Histogram>(info[0].As<v8::Object>());
+  if (other->sub != obj->sub) {
+    Nan::ThrowRangeError("Cannot merge histograms with different subBucketBits");
+    return;
+  }
+  for (size_t i=0; i < obj->counts.size(); i++) {
+    obj->counts[i] += other->counts[i];
+  }
+  obj->total += other->total;
+  if (other->total) {
+    if (other->min < obj->min) obj->min = other->min;
+    if (other->max > obj->max) obj->max = other->max;
+  }
+}
+
+NAN_METHOD(Histogram::ResetMethod)
+{
+  if (Histogram *obj = This(info)) {
+    obj->Reset();
+  }
+}
+
+// -- serialization
+
+static void putVarint(std::vector<char> &out,uint64_t val)
+{
+  while (val >= 0x80) {
+    out.push_back((char)(val | 0x80));
+    val >>= 7;
+  }
+  out.push_back((char)val);
+}
+
+static bool getVarint(const unsigned char *&pos,const unsigned char *end,uint64_t &ret)
+{
+  ret = 0;
+  for (int shift=0; (pos!=end)&&(shift<64); shift+=7) {
+    const unsigned char c = *pos++;
+    ret |= (uint64_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static const char histMagic[4] = { 'U', '6', '4', 'H' };
+
+NAN_METHOD(Histogram::Serialize)
+{
+  Histogram *obj = This(info);
+  if (!obj) {
+    return;
+  }
+  std::vector<char> out(histMagic, histMagic+4);
+  out.push_back(1); // version
+  out.push_back((char)obj->sub);
+  out.push_back(0);
+  out.push_back(0);
+  putVarint(out, (obj->total) ? obj->min : 0);
+  putVarint(out, obj->max);
+
+  uint64_t zeros = 0;
+  for (size_t i=0; i < obj->counts.size(); i++) {
+    const uint64_t count = obj->counts[i];
+    if (!count) {
+      zeros++;
+      continue;
+    }
+    if (zeros) {
+      putVarint(out, ((zeros-1)<<1) | 1); // zigzag(-zeros)
+      zeros = 0;
+    }
+    putVarint(out, count<<1); // zigzag; counts >= 2^63 are not representable
+  }
+  RET(Nan::CopyBuffer(&out[0], out.size()).ToLocalChecked());
+}
+
+NAN_METHOD(Histogram::Deserialize)
+{
+  if (!info[0]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer as argument");
+    return;
+  }
+  const unsigned char *pos = (const unsigned char *)node::Buffer::Data(info[0]),
+                      *end = pos + node::Buffer::Length(info[0]);
+  if ( (end-pos < 8)||(memcmp(pos, histMagic, 4) != 0)||(pos[4] != 1) ) {
+    Nan::ThrowError("Not a serialized Histogram (or unsupported version)");
+    return;
+  } else if ( (pos[5]<1)||(pos[5]>LOGHIST_MAX_SUB) ) {
+    Nan::ThrowError("Corrupt Histogram");
+    return;
+  }
+  v8::Local<v8::Value> arg = Nan::New<v8::Int32>((int32_t)pos[5]);
+  v8::Local<v8::Object> ret = Nan::New(AddonData::Get()->histogramConstructor)->NewInstance(1, &arg);
+  Histogram *obj = Nan::ObjectWrap::Unwrap<Histogram>(ret);
+  pos += 8;
+
+  uint64_t min, max, val;
+  if ( (!getVarint(pos, end, min))||(!getVarint(pos, end, max)) ) {
+    Nan::ThrowError("Truncated Histogram");
+    return;
+  }
+  size_t idx = 0;
+  while (pos != end) {
+    if (!getVarint(pos, end, val)) {
+      Nan::ThrowError("Truncated Histogram");
+      return;
+    }
+    const uint64_t n = (val>>1) + (val&1); // count or number of empty buckets
+    if ( (val&1) ? (n > obj->counts.size() - idx) : (idx >= obj->counts.size()) ) {
+      Nan::ThrowError("Corrupt Histogram");
+      return;
+    }
+    if (val&1) {
+      idx += n;
+    } else {
+      obj->counts[idx++] = n;
+      obj->total += n;
+    }
+  }
+  if (obj->total) {
+    obj->min = min;
+    obj->max = max;
+  }
+  RET(ret);
+}
@@ -0,0 +1,52 @@
+#ifndef _HISTOGRAM_H
+#define _HISTOGRAM_H
+
+#include <nan.h>
+#include <vector>
+
+/* Provides:
+
+new u64.Histogram(subBucketBits=8)   - 1..16, relative bucket width 2^-(subBucketBits-1)
+
+.record(value[,count=1])      - value: Number, String, BigInt or UInt64
+.recordBatch(column)          - packed u64 column
+.percentile(p):UInt64         - 0 <= p <= 100; highest value equivalent to the p-th percentile
+.merge(other)                 - other must have the same subBucketBits
+.reset()
+.totalCount:Number, .min:UInt64, .max:UInt64, .subBucketBits:Number
+
+.serialize():Buffer, Histogram.deserialize(buffer):Histogram
+* format: "U64H", version=1, subBucketBits, 0, 0, varint min, varint max,
+*         then zigzag varints: n>0: bucket count n, n<0: -n empty buckets (trailing empty buckets omitted)
+*/
+
+class Histogram : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  explicit Histogram(unsigned int sub);
+
+  unsigned int sub;
+  std::vector<uint64_t> counts;
+  uint64_t total, min, max;
+
+  void Reset();
+
+  static Histogram *This(Nan::NAN_METHOD_ARGS_TYPE info);
+
+  static NAN_METHOD(New);
+  static NAN_METHOD(Deserialize);
+  static NAN_GETTER(GetTotalCount);
+  static NAN_GETTER(GetMin);
+  static NAN_GETTER(GetMax);
+  static NAN_GETTER(GetSubBucketBits);
+
+  static NAN_METHOD(Record);
+  static NAN_METHOD(RecordBatch);
+  static NAN_METHOD(Percentile);
+  static NAN_METHOD(Merge);
+  static NAN_METHOD(ResetMethod);
+  static NAN_METHOD(Serialize);
+};
+
+#endif
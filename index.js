@@ -4,9 +4,17 @@
 //                   add, sub, rsub, and, or, xor, // same for signed
 //                   shl, shr, sar, rol, ror,
 //                   add2, sub2                    // take+return carry
+//                   bswap, bitReverse, blsr, blsi,
+//                   pdep(mask), pext(mask),
+//                   extractBits(start,len), insertBits(bits,start,len)
+//         Non-Mutating: negate, bitNot, magnitude, plus, minus, bitAnd, bitOr, bitXor,
+//                       bitShl, bitShr, bitSar, bitRol, bitRor     // (...args[,out])
+//                       UInt64.neg(a[,out]), UInt64.add(a,b[,out]), UInt64.shl(a,n[,out]), ...
 //         Tests: eq, lt, gt, ilt, igt, isZero
 //                UInt64.Compare, Int64.Compare
-//         More: toString, clz, ctz
+//         Parsing: new UInt64(str) throws on invalid/out of range strings (0x, 0b, 0o, '_' allowed),
+//                  UInt64.tryParse(str), Int64.tryParse(str) return null instead
+//         More: toString, clz, ctz, popcnt, parity
 
 // TODO? .toString default radix==16 ?
 // and/or:  .toHexString(padding?,signed?)  with leading '0x' ?
@@ -91,58 +99,7 @@ UInt64.prototype.grabDouble = function(roundUp) {
 };
 
 
-// Non-Mutating Api
-UInt64.prototype.negate = function() {
-  return this.clone().neg();
-};
-
-UInt64.prototype.magnitude = function() {
-  return this.clone().abs();
-};
-
-UInt64.prototype.plus = function(rhs) {
-  return this.clone().add(rhs);
-};
-
-UInt64.prototype.minus = function(rhs) {
-  return this.clone().sub(rhs);
-};
-
-UInt64.prototype.bitNot = function() {
-  return this.clone().not();
-};
-
-UInt64.prototype.bitAnd = function(rhs) {
-  return this.clone().and(rhs);
-};
-
-UInt64.prototype.bitOr = function(rhs) {
-  return this.clone().or(rhs);
-};
-
-UInt64.prototype.bitXor = function(rhs) {
-  return this.clone().xor(rhs);
-};
-
-UInt64.prototype.bitShl = function(rhs) {
-  return this.clone().shl(rhs);
-};
-
-UInt64.prototype.bitShr = function(rhs) {
-  return this.clone().shr(rhs);
-};
-
-UInt64.prototype.bitSar = function(rhs) {
-  return this.clone().sar(rhs);
-};
-
-UInt64.prototype.bitRol = function(rhs) {
-  return this.clone().rol(rhs);
-};
-
-UInt64.prototype.bitRor = function(rhs) {
-  return this.clone().ror(rhs);
-};
+// Non-Mutating Api: native, cf. UINT64_*_COPY_OPS in uint64.h
 
 
 // long forms
@@ -184,6 +141,21 @@ Int64.prototype.grabDouble = function(roundAwayFromZero/*=false*/) {
 };
 
 
+u64.ParseStream=require('./stream'); // cf. TextParser
+
+var columnFile=require('./columnfile'); // cf. MappedFile
+u64.mapFile=columnFile.mapFile;
+u64.createColumnFile=columnFile.createColumnFile;
+
+if (require('v8').DefaultSerializer) { // node >= 8
+  var serialize=require('./serialize');
+  u64.Serializer=serialize.Serializer;
+  u64.Deserializer=serialize.Deserializer;
+  u64.encodeMessage=serialize.encodeMessage;
+  u64.decodeMessage=serialize.decodeMessage;
+}
+
+
 module.exports=u64;
 
 
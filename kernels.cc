@@ -0,0 +1,49 @@
+#include "kernels.h"
+#include "ext/cpuid.h"
+#include <stdlib.h>
+#include <string.h>
+
+const u64_kernels *u64k = &u64k_generic;
+
+// best first
+static const u64_kernels *const variants[] = {
+#ifdef U64K_X86
+  &u64k_avx512,
+  &u64k_avx2,
+  &u64k_sse42,
+#endif
+  &u64k_generic
+};
+
+unsigned int u64k_cpu_features()
+{
+  static const unsigned int features = cpu_features();
+  return features;
+}
+
+static const u64_kernels *Select()
+{
+  const unsigned int features = u64k_cpu_features();
+  const char *force = getenv("U64_KERNELS");
+  const u64_kernels *best = 0;
+  for (size_t i=0; i<sizeof(variants)/sizeof(*variants); i++) {
+    const u64_kernels *k = variants[i];
+    if ((k->required & features) != k->required) {
+      continue;
+    }
+    if ( (force)&&(strcmp(force, k->name) == 0) ) {
+      best = k;
+      break;
+    } else if (!best) {
+      best = k;
+    }
+  }
+  return best;
+}
+
+// once per process: worker threads may load the module while others already use u64k
+void u64k_init()
+{
+  static const bool done = (u64k = Select(), true);
+  (void)done;
+}
@@ -0,0 +1,52 @@
+#ifndef _KERNELS_H
+#define _KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Provides:
+
+u64k->...   - the bit kernels of ext/, compiled once per ISA variant (kernels_*.cc),
+              best supported variant is selected by u64k_init() via CPUID
+* only ops some ISA does better; shifts, rotates and adc/sbb are the same instructions
+  everywhere: use ext/shifts.h, ext/adc_sbb.h directly (inlined, no indirect call)
+
+Variants: generic, sse42 (+POPCNT), avx2 (+LZCNT, BMI1/2), avx512 (+F, CD, VL, BW, DQ)
+* environment U64_KERNELS=<name> selects a specific variant, if supported by the CPU
+  (U64_KERNELS=generic forces the portable fallback)
+*/
+
+struct u64_kernels {
+  const char *name;
+  unsigned int required; // CPU_* from ext/cpuid.h
+
+  unsigned int (*clz32)(uint32_t val);
+  unsigned int (*ctz32)(uint32_t val);
+  unsigned int (*popcnt32)(uint32_t val);
+  unsigned int (*clz64)(uint64_t val);
+  unsigned int (*ctz64)(uint64_t val);
+  unsigned int (*popcnt64)(uint64_t val);
+  unsigned int (*parity64)(uint64_t val);
+  uint64_t (*pdep64)(uint64_t val,uint64_t mask);
+  uint64_t (*pext64)(uint64_t val,uint64_t mask);
+
+  // batch loops
+  void (*bloom_insert_batch)(uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,int atomic);
+  void (*bloom_probe_batch)(const uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,uint8_t *out);
+  void (*bitop_batch)(int op,uint64_t *dst,const uint64_t *src,size_t n,uint64_t mask,unsigned int start,unsigned int len);
+  void (*loghist_record_batch)(uint64_t *counts,unsigned int sub,const uint64_t *vals,size_t n,uint64_t *min,uint64_t *max);
+};
+
+extern const u64_kernels *u64k;
+
+void u64k_init();
+unsigned int u64k_cpu_features();
+
+extern const u64_kernels u64k_generic;
+#ifdef U64K_X86
+extern const u64_kernels u64k_sse42;
+extern const u64_kernels u64k_avx2;
+extern const u64_kernels u64k_avx512;
+#endif
+
+#endif
@@ -0,0 +1,5 @@
+// compiled with -mavx2 -mpopcnt -mlzcnt -mbmi -mbmi2
+#define U64K_VARIANT u64k_avx2
+#define U64K_NAME "avx2"
+#define U64K_REQUIRES (CPU_SSE42|CPU_POPCNT|CPU_LZCNT|CPU_BMI1|CPU_BMI2|CPU_AVX2)
+#include "kernels_impl.h"
@@ -0,0 +1,6 @@
+// compiled with the avx2 flags plus -mavx512f -mavx512cd -mavx512vl -mavx512bw -mavx512dq
+#define U64K_VARIANT u64k_avx512
+#define U64K_NAME "avx512"
+#define U64K_REQUIRES (CPU_SSE42|CPU_POPCNT|CPU_LZCNT|CPU_BMI1|CPU_BMI2|CPU_AVX2| \
+                       CPU_AVX512F|CPU_AVX512CD|CPU_AVX512VL|CPU_AVX512BW|CPU_AVX512DQ)
+#include "kernels_impl.h"
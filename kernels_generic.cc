@@ -0,0 +1,5 @@
+// compiled with default flags
+#define U64K_VARIANT u64k_generic
+#define U64K_NAME "generic"
+#define U64K_REQUIRES 0
+#include "kernels_impl.h"
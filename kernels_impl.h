@@ -0,0 +1,59 @@
+// included once per ISA variant, see kernels_*.cc (no include guard!)
+// CAVE: everything here must have internal linkage -- an inline or template function with
+// external linkage (e.g. from <algorithm>) could be merged by the linker with its copy from
+// another variant, which then executes unsupported instructions.
+
+#if !defined(U64K_VARIANT) || !defined(U64K_NAME) || !defined(U64K_REQUIRES)
+#error U64K_VARIANT, U64K_NAME and U64K_REQUIRES must be defined
+#endif
+
+#include "kernels.h"
+#include "ext/cpuid.h"
+#include "ext/bitcount.h"
+#include "ext/bitops.h"
+#include "ext/blockbloom.h"
+#include "ext/loghist.h"
+
+namespace {
+
+unsigned int k_clz32(uint32_t val) { return clz32(val); }
+unsigned int k_ctz32(uint32_t val) { return ctz32(val); }
+unsigned int k_popcnt32(uint32_t val) { return popcnt32(val); }
+unsigned int k_clz64(uint64_t val) { return clz64(val); }
+unsigned int k_ctz64(uint64_t val) { return ctz64(val); }
+unsigned int k_popcnt64(uint64_t val) { return popcnt64(val); }
+unsigned int k_parity64(uint64_t val) { return parity64(val); }
+uint64_t k_pdep64(uint64_t val,uint64_t mask) { return pdep64(val,mask); }
+uint64_t k_pext64(uint64_t val,uint64_t mask) { return pext64(val,mask); }
+
+void k_bloom_insert_batch(uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,int atomic)
+{
+  bloom_insert_batch(words,blocks,keys,n,atomic);
+}
+
+void k_bloom_probe_batch(const uint64_t *words,size_t blocks,const uint64_t *keys,size_t n,uint8_t *out)
+{
+  bloom_probe_batch(words,blocks,keys,n,out);
+}
+
+void k_bitop_batch(int op,uint64_t *dst,const uint64_t *src,size_t n,uint64_t mask,unsigned int start,unsigned int len)
+{
+  bitop_batch(op,dst,src,n,mask,start,len);
+}
+
+void k_loghist_record_batch(uint64_t *counts,unsigned int sub,const uint64_t *vals,size_t n,uint64_t *min,uint64_t *max)
+{
+  loghist_record_batch(counts,sub,vals,n,min,max);
+}
+
+} // namespace
+
+extern const u64_kernels U64K_VARIANT = {
+  U64K_NAME, U64K_REQUIRES,
+  k_clz32, k_ctz32, k_popcnt32,
+  k_clz64, k_ctz64, k_popcnt64,
+  k_parity64, k_pdep64, k_pext64,
+  k_bloom_insert_batch, k_bloom_probe_batch,
+  k_bitop_batch,
+  k_loghist_record_batch
+};
@@ -0,0 +1,5 @@
+// compiled with -msse4.2 -mpopcnt
+#define U64K_VARIANT u64k_sse42
+#define U64K_NAME "sse42"
+#define U64K_REQUIRES (CPU_SSE42|CPU_POPCNT)
+#include "kernels_impl.h"
@@ -1,8 +1,21 @@
 #include <nan.h>
 #include <math.h> // cmath?
+#include "addondata.h"
 #include "uint64.h"
+#include "bloomfilter.h"
+#include "histogram.h"
+#include "textparser.h"
+#include "mappedfile.h"
+#include "modulus.h"
+#include "recordschema.h"
+#include "fixedpoint.h"
+#include "batch.h"
+#include "scan.h"
+#include "selection.h"
+#include "stats.h"
 #include "ext/binary64util.h"
-#include "ext/bitcount.h"
+#include "ext/cpuid.h"
+#include "kernels.h"
 
 /* Provides:
 
@@ -10,6 +23,9 @@ u64.clz32
 u64.ctz32
 u64.popcnt32
 
+u64.cpuFeatures() -> {kernels:String, popcnt:bool, lzcnt:bool, ...}
+* kernels: selected ISA variant (cf. kernels.h; environment U64_KERNELS=generic forces the portable one)
+
 u64.buildDouble(sign[+/-1],mantissa:UInt64,exponent:int):Number
 * (-1023 <= exponent <= 1024); -1023 and 1024 are special
 * 0 must be encoded with mantissa==0, exponent==-1023
@@ -17,6 +33,11 @@ u64.buildDouble(sign[+/-1],mantissa:UInt64,exponent:int):Number
 
 u64.splitDouble(d) -> {sign,mantissa,exponent,isNormal:bool}
 
+u64.hrtime([out:UInt64]):UInt64
+* monotonic clock in nanoseconds; writes into out (no allocation), if given
+
+u64.stats(), u64.resetStats([samplePeriod])  - cf. stats.h
+
 */
 
 static NAN_METHOD(Clz32)
@@ -25,7 +46,7 @@ static NAN_METHOD(Clz32)
     Nan::ThrowTypeError("Expected Number as argument");
     return;
   }
-  info.GetReturnValue().Set(clz32(info[0]->Uint32Value()));
+  info.GetReturnValue().Set(u64k->clz32(info[0]->Uint32Value()));
 }
 
 static NAN_METHOD(Ctz32)
@@ -34,7 +55,7 @@ static NAN_METHOD(Ctz32)
     Nan::ThrowTypeError("Expected Number as argument");
     return;
   }
-  info.GetReturnValue().Set(ctz32(info[0]->Uint32Value()));
+  info.GetReturnValue().Set(u64k->ctz32(info[0]->Uint32Value()));
 }
 
 static NAN_METHOD(Popcnt32)
@@ -43,7 +64,25 @@ static NAN_METHOD(Popcnt32)
     Nan::ThrowTypeError("Expected Number as argument");
     return;
   }
-  info.GetReturnValue().Set(popcnt32(info[0]->Uint32Value()));
+  info.GetReturnValue().Set(u64k->popcnt32(info[0]->Uint32Value()));
+}
+
+static NAN_METHOD(CpuFeatures)
+{
+  static const struct { const char *name; unsigned int bit; } flags[] = {
+    {"sse42", CPU_SSE42}, {"popcnt", CPU_POPCNT}, {"lzcnt", CPU_LZCNT},
+    {"bmi1", CPU_BMI1}, {"bmi2", CPU_BMI2}, {"avx2", CPU_AVX2},
+    {"avx512f", CPU_AVX512F}, {"avx512cd", CPU_AVX512CD}, {"avx512vl", CPU_AVX512VL},
+    {"avx512bw", CPU_AVX512BW}, {"avx512dq", CPU_AVX512DQ}
+  };
+  const unsigned int features = u64k_cpu_features();
+
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+  ret->Set(Nan::New("kernels").ToLocalChecked(),Nan::New(u64k->name).ToLocalChecked());
+  for (size_t i=0; i<sizeof(flags)/sizeof(*flags); i++) {
+    ret->Set(Nan::New(flags[i].name).ToLocalChecked(),Nan::New((bool)(features & flags[i].bit)));
+  }
+  info.GetReturnValue().Set(ret);
 }
 
 static NAN_METHOD(buildDouble)
@@ -110,17 +149,49 @@ static NAN_METHOD(splitDouble)
   info.GetReturnValue().Set(ret);
 }
 
+static NAN_METHOD(Hrtime)
+{
+  const uint64_t now = uv_hrtime();
+  if (info[0]->IsUndefined()) {
+    info.GetReturnValue().Set(UInt64::NewInstance(now));
+    return;
+  } else if (!UInt64::HasInstance(info[0])) {
+    Nan::ThrowTypeError("Expected UInt64 as argument");
+    return;
+  }
+  UInt64::SetValue(info[0], now);
+  info.GetReturnValue().Set(info[0]);
+}
+
+// once per isolate: main thread and each worker_threads Worker (cf. addondata.h)
 static NAN_MODULE_INIT(init)
 {
+  u64k_init();
+  AddonData::Init();
+
   UInt64::Init(target);
+  BloomFilter::Init(target);
+  Histogram::Init(target);
+  TextParser::Init(target);
+  MappedFile::Init(target);
+  Modulus::Init(target);
+  RecordSchema::Init(target);
+  FixedPoint::Init(target);
+  InitBatch(target);
+  InitScan(target);
+  InitSelect(target);
+  InitStats(target);
 
   Nan::SetMethod(target, "clz32", Clz32);
   Nan::SetMethod(target, "ctz32", Ctz32);
   Nan::SetMethod(target, "popcnt32", Popcnt32);
+  Nan::SetMethod(target, "cpuFeatures", CpuFeatures);
 
   Nan::SetMethod(target, "buildDouble", buildDouble);
   Nan::SetMethod(target, "splitDouble", splitDouble);
+
+  Nan::SetMethod(target, "hrtime", Hrtime);
 }
 
-NODE_MODULE(u64, init)
+NAN_MODULE_WORKER_ENABLED(u64, init)
 
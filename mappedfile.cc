@@ -0,0 +1,320 @@
+#include "mappedfile.h"
+#include "addondata.h"
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// page aligned region actually mapped; owned (and freed) by the column Buffer
+struct MappedFile::Mapping {
+  void *addr;
+  size_t len;
+};
+
+NAN_MODULE_INIT(MappedFile::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("MappedFile").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->mappedFileTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("column").ToLocalChecked(), GetColumn);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("length").ToLocalChecked(), GetLength);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("signed").ToLocalChecked(), GetSigned);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("bigEndian").ToLocalChecked(), GetBigEndian);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("readonly").ToLocalChecked(), GetReadonly);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("header").ToLocalChecked(), GetHeader);
+
+  Nan::SetPrototypeMethod(tpl, "advise", Advise);
+  Nan::SetPrototypeMethod(tpl, "sync", Sync);
+  Nan::SetPrototypeMethod(tpl, "unmap", Unmap);
+
+  Nan::Set(target, Nan::New("MappedFile").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+void MappedFile::FreeMapping(char *data,void *hint)
+{
+  Mapping *mapping = (Mapping *)hint;
+#ifndef _WIN32
+  if (mapping->addr) {
+    munmap(mapping->addr, mapping->len);
+  }
+#endif
+  delete mapping;
+}
+
+MappedFile *MappedFile::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->mappedFileTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad MappedFile object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+}
+
+// NULL after unmap(): the column Buffer may already have freed the Mapping
+MappedFile::Mapping *MappedFile::MappingOf(MappedFile *obj)
+{
+  if (!obj) {
+    return 0;
+  } else if (!obj->mapping) {
+    Nan::ThrowError("MappedFile is unmapped");
+  }
+  return obj->mapping;
+}
+
+static void ThrowSysError(const char *syscall,const char *path)
+{
+  char msg[512];
+  snprintf(msg, sizeof(msg), "%s '%s': %s", syscall, path, strerror(errno));
+  Nan::ThrowError(msg);
+}
+
+// optional Number argument, multiple of 8
+static bool ByteArgument(v8::Local<v8::Value> arg,const char *name,double &ret)
+{
+  if (arg->IsUndefined()) {
+    ret = -1;
+    return true;
+  } else if (!arg->IsNumber()) {
+    char msg[64];
+    snprintf(msg, sizeof(msg), "Expected Number as %s", name);
+    Nan::ThrowTypeError(msg);
+    return false;
+  }
+  ret = arg->NumberValue();
+  if ( (!(ret >= 0))||(ret != (double)(uint64_t)ret)||((uint64_t)ret%8 != 0) ) {
+    char msg[64];
+    snprintf(msg, sizeof(msg), "%s must be a non-negative multiple of 8", name);
+    Nan::ThrowRangeError(msg);
+    return false;
+  }
+  return true;
+}
+
+NAN_METHOD(MappedFile::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("MappedFile must be called with new");
+    return;
+  } else if (!info[0]->IsString()) {
+    Nan::ThrowTypeError("Expected String as first argument");
+    return;
+  }
+#ifdef _WIN32
+  Nan::ThrowError("MappedFile is not supported on Windows");
+#else
+  Nan::Utf8String path(info[0]);
+  const bool readonly = info[1]->BooleanValue();
+  double offset, length;
+  if ( (!ByteArgument(info[2], "offset", offset))||(!ByteArgument(info[3], "length", length)) ) {
+    return;
+  }
+  if (offset < 0) {
+    offset = 0;
+  }
+
+  const int fd = open(*path, readonly ? O_RDONLY : O_RDWR);
+  if (fd < 0) {
+    ThrowSysError("open", *path);
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    ThrowSysError("fstat", *path);
+    close(fd);
+    return;
+  }
+  const uint64_t fileSize = st.st_size;
+
+  // header
+  unsigned char hdr[U64C_HEADER_SIZE];
+  bool header = false;
+  unsigned int flags = 0;
+  uint64_t dataSize = fileSize;
+  if ( (!info[4]->IsUndefined())&&(!info[4]->BooleanValue()) ) {
+    // raw
+  } else if ( (fileSize >= U64C_HEADER_SIZE)&&(pread(fd, hdr, U64C_HEADER_SIZE, 0) == U64C_HEADER_SIZE)&&
+              (memcmp(hdr, "U64C", 4) == 0) ) {
+    if (hdr[4] != U64C_VERSION) {
+      Nan::ThrowError("Unsupported column file version");
+      close(fd);
+      return;
+    }
+    uint64_t count = 0;
+    for (int i=7; i>=0; i--) {
+      count = (count<<8) | hdr[8+i];
+    }
+    if (count > (fileSize - U64C_HEADER_SIZE) / 8) {
+      Nan::ThrowError("Column file is shorter than its header says");
+      close(fd);
+      return;
+    }
+    header = true;
+    flags = hdr[5];
+    dataSize = count * 8;
+  } else if (info[4]->BooleanValue()) {
+    Nan::ThrowError("Missing column file header");
+    close(fd);
+    return;
+  }
+
+  if ( (offset > (double)dataSize)||((length >= 0)&&(offset + length > (double)dataSize)) ) {
+    Nan::ThrowRangeError("Range exceeds file size");
+    close(fd);
+    return;
+  }
+  const uint64_t window = (length >= 0) ? (uint64_t)length : dataSize - (uint64_t)offset;
+  if (window > (uint64_t)node::Buffer::kMaxLength) {
+    Nan::ThrowRangeError("Range exceeds the maximum Buffer length: map a smaller window with offset/length");
+    close(fd);
+    return;
+  }
+  const size_t bytes = (size_t)window;
+  const uint64_t start = (header ? U64C_HEADER_SIZE : 0) + (uint64_t)offset;
+
+  Mapping *mapping = new Mapping();
+  mapping->addr = 0;
+  mapping->len = 0;
+  char *data;
+  if (bytes) {
+    const uint64_t pageStart = start & ~(uint64_t)(sysconf(_SC_PAGESIZE) - 1);
+    mapping->len = (start - pageStart) + bytes;
+    // readonly: private copy-on-write, as the Buffer is writable from JS
+    void *addr = mmap(0, mapping->len, PROT_READ | PROT_WRITE, readonly ? MAP_PRIVATE : MAP_SHARED, fd, pageStart);
+    if (addr == MAP_FAILED) {
+      ThrowSysError("mmap", *path);
+      delete mapping;
+      close(fd);
+      return;
+    }
+    mapping->addr = addr;
+    data = (char *)addr + (start - pageStart);
+  } else {
+    static char empty;
+    data = &empty;
+  }
+  close(fd); // mapping stays valid
+
+  v8::Local<v8::Object> column;
+  if (!Nan::NewBuffer(data, bytes, FreeMapping, mapping).ToLocal(&column)) {
+    Nan::ThrowError("Cannot create the column Buffer"); // mapping: left to FreeMapping, if node calls it
+    return;
+  }
+  MappedFile *obj = new MappedFile(column, mapping, data, bytes, readonly, header, flags);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+#endif
+}
+
+NAN_GETTER(MappedFile::GetColumn)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set(Nan::New(obj->column));
+}
+
+NAN_GETTER(MappedFile::GetLength)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set((double)(obj->bytes / 8));
+}
+
+NAN_GETTER(MappedFile::GetSigned)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set((bool)(obj->flags & U64C_FLAG_SIGNED));
+}
+
+NAN_GETTER(MappedFile::GetBigEndian)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set((bool)(obj->flags & U64C_FLAG_BIGENDIAN));
+}
+
+NAN_GETTER(MappedFile::GetReadonly)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set(obj->readonly);
+}
+
+NAN_GETTER(MappedFile::GetHeader)
+{
+  MappedFile *obj = Nan::ObjectWrap::Unwrap<MappedFile>(info.Holder());
+  info.GetReturnValue().Set(obj->header);
+}
+
+NAN_METHOD(MappedFile::Advise)
+{
+  Mapping *mapping = MappingOf(This(info));
+  if (!mapping) {
+    return;
+  } else if (!info[0]->IsString()) {
+    Nan::ThrowTypeError("Expected String as argument");
+    return;
+  }
+#ifndef _WIN32
+  static const struct { const char *name; int advice; } hints[] = {
+    {"normal", MADV_NORMAL}, {"sequential", MADV_SEQUENTIAL}, {"random", MADV_RANDOM},
+    {"willneed", MADV_WILLNEED}, {"dontneed", MADV_DONTNEED}
+  };
+  Nan::Utf8String hint(info[0]);
+  for (size_t i=0; i<sizeof(hints)/sizeof(*hints); i++) {
+    if (strcmp(*hint, hints[i].name) == 0) {
+      if ( (mapping->addr)&&(madvise(mapping->addr, mapping->len, hints[i].advice) < 0) ) {
+        ThrowSysError("madvise", *hint);
+      }
+      return;
+    }
+  }
+#endif
+  Nan::ThrowRangeError("Expected 'normal', 'sequential', 'random', 'willneed' or 'dontneed'");
+}
+
+NAN_METHOD(MappedFile::Sync)
+{
+  MappedFile *obj = This(info);
+  Mapping *mapping = MappingOf(obj);
+  if (!mapping) {
+    return;
+  }
+#ifndef _WIN32
+  if ( (mapping->addr)&&(!obj->readonly)&&
+       (msync(mapping->addr, mapping->len, info[0]->BooleanValue() ? MS_ASYNC : MS_SYNC) < 0) ) {
+    ThrowSysError("msync", "column");
+  }
+#endif
+}
+
+NAN_METHOD(MappedFile::Unmap)
+{
+  MappedFile *obj = This(info);
+  if ( (!obj)||(!obj->mapping) ) {
+    return;
+  }
+  // take the region over: detaching may run FreeMapping right away (or at the next GC)
+  Mapping *mapping = obj->mapping;
+  void *addr = mapping->addr;
+  const size_t len = mapping->len;
+  mapping->addr = 0;
+  obj->mapping = 0;
+  obj->data = 0;
+  obj->bytes = 0;
+
+  // detach first: no view may point into the unmapped range
+  v8::Local<v8::ArrayBuffer> ab = Nan::New(obj->column).As<v8::Uint8Array>()->Buffer();
+#if NODE_MAJOR_VERSION >= 12
+  ab->Detach();
+#else
+  ab->Neuter();
+#endif
+#ifndef _WIN32
+  if (addr) {
+    munmap(addr, len);
+  }
+#endif
+}
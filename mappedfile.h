@@ -0,0 +1,72 @@
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <nan.h>
+
+/* Provides: memory-mapped u64 column files (POSIX only), cf. u64.mapFile in columnfile.js
+
+new u64.MappedFile(path,readonly,offset,length,header)
+* offset, length: in bytes, relative to the data (i.e. after the header, if any); multiples of 8;
+  length===undefined: up to the end of the data; RangeError beyond node's max. Buffer length
+* header: true (required), false (raw file), undefined (detect by magic)
+* readonly: mapped copy-on-write, so writes through .column stay private and never reach the file
+
+.column        - Buffer over the mapped values (zero-copy, 8 byte aligned packed u64 column: usable
+                 with every *Batch function); length 0 after unmap()
+.length        - number of values
+.signed, .bigEndian  - from the header (false for raw files);
+                 bigEndian data is not host order: cf. u64.bswapBatch(column, dst)
+.readonly, .header
+.advise(hint)  - 'normal', 'sequential', 'random', 'willneed' or 'dontneed' (madvise)
+.sync([async=false])  - msync, writes dirty pages back to the file
+.unmap()       - releases the mapping immediately (otherwise: when .column is garbage collected);
+                 advise() and sync() throw afterwards
+
+file header (32 bytes, all little-endian):
+  0: "U64C"  4: u8 version (1)  5: u8 flags (1: signed, 2: big-endian)  6: u16 0
+  8: u64 count  16: 16 bytes 0  32: count values
+* truncating the file while mapped makes accesses beyond the new end crash (SIGBUS)
+*/
+
+#define U64C_HEADER_SIZE 32
+#define U64C_VERSION 1
+#define U64C_FLAG_SIGNED 0x01
+#define U64C_FLAG_BIGENDIAN 0x02
+
+class MappedFile : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  struct Mapping;
+
+  MappedFile(v8::Local<v8::Object> column,Mapping *mapping,char *data,size_t bytes,bool readonly,
+             bool header,unsigned int flags)
+    : column(column), mapping(mapping), data(data), bytes(bytes), readonly(readonly),
+      header(header), flags(flags) {}
+  ~MappedFile() { column.Reset(); }
+
+  Nan::Persistent<v8::Object> column; // owns mapping
+  Mapping *mapping; // NULL after unmap()
+  char *data;
+  size_t bytes;
+  bool readonly, header;
+  unsigned int flags;
+
+  static void FreeMapping(char *data,void *hint);
+  static MappedFile *This(Nan::NAN_METHOD_ARGS_TYPE info);
+  static Mapping *MappingOf(MappedFile *obj);
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetColumn);
+  static NAN_GETTER(GetLength);
+  static NAN_GETTER(GetSigned);
+  static NAN_GETTER(GetBigEndian);
+  static NAN_GETTER(GetReadonly);
+  static NAN_GETTER(GetHeader);
+
+  static NAN_METHOD(Advise);
+  static NAN_METHOD(Sync);
+  static NAN_METHOD(Unmap);
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "modulus.h"
+#include "addondata.h"
+#include "uint64.h"
+#include "column.h"
+
+NAN_MODULE_INIT(Modulus::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("Modulus").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->modulusTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("modulus").ToLocalChecked(), GetModulus);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("montgomery").ToLocalChecked(), GetMontgomery);
+
+  Nan::SetPrototypeMethod(tpl, "reduce", Reduce);
+  Nan::SetPrototypeMethod(tpl, "inverse", Inverse);
+  Nan::SetPrototypeMethod(tpl, "reduceBatch", ReduceBatch);
+  Nan::SetPrototypeMethod(tpl, "inverseBatch", InverseBatch);
+#define X(name,fn) \
+  Nan::SetPrototypeMethod(tpl, #name, name); \
+  Nan::SetPrototypeMethod(tpl, #name "Batch", name ## Batch);
+  MODULUS_BINARY_OPS
+#undef X
+
+  Nan::Set(target, Nan::New("Modulus").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+
+  Nan::SetMethod(target, "isPrime", IsPrime);
+  Nan::SetMethod(target, "isPrimeBatch", IsPrimeBatch);
+}
+
+Modulus *Modulus::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->modulusTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad Modulus object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<Modulus>(info.Holder());
+}
+
+NAN_METHOD(Modulus::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("Modulus must be called with new");
+    return;
+  }
+  uint64_t m;
+  if (!UInt64::FromArgument(info[0],m)) {
+    return;
+  } else if (!m) {
+    Nan::ThrowRangeError("Modulus must not be 0");
+    return;
+  }
+
+  Modulus *obj = new Modulus(m);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(Modulus::GetModulus)
+{
+  Modulus *obj = Nan::ObjectWrap::Unwrap<Modulus>(info.Holder());
+  info.GetReturnValue().Set(UInt64::NewInstance(obj->ctx.m));
+}
+
+NAN_GETTER(Modulus::GetMontgomery)
+{
+  Modulus *obj = Nan::ObjectWrap::Unwrap<Modulus>(info.Holder());
+  info.GetReturnValue().Set((bool)obj->ctx.mont);
+}
+
+NAN_METHOD(Modulus::Reduce)
+{
+  Modulus *obj = This(info);
+  uint64_t a;
+  if ( (obj)&&(UInt64::FromArgument(info[0],a)) ) {
+    UInt64::SetResult(info, 1, mod_reduce(&obj->ctx, a), false);
+  }
+}
+
+NAN_METHOD(Modulus::Inverse)
+{
+  Modulus *obj = This(info);
+  uint64_t a, ret;
+  if ( (!obj)||(!UInt64::FromArgument(info[0],a)) ) {
+    return;
+  } else if (!mod_inverse(&obj->ctx, a, &ret)) {
+    Nan::ThrowRangeError("Not invertible: argument and modulus are not coprime");
+    return;
+  }
+  UInt64::SetResult(info, 1, ret, false);
+}
+
+#define X(name,fn) \
+  NAN_METHOD(Modulus::name)                     \
+  {                                             \
+    Modulus *obj = This(info);                  \
+    uint64_t a, b;                              \
+    if ( (obj)&&(UInt64::FromArgument(info[0],a))&&(UInt64::FromArgument(info[1],b)) ) { \
+      UInt64::SetResult(info, 2, fn(&obj->ctx, a, b), false); \
+    }                                           \
+  }
+MODULUS_BINARY_OPS
+#undef X
+
+NAN_METHOD(Modulus::ReduceBatch)
+{
+  Modulus *obj = This(info);
+  U64Column src, dst;
+  if ( (obj)&&(U64Column::FromArgument(info[0],src))&&(U64Column::DstArgument(info,1,src,dst)) ) {
+    mod_reduce_batch(&obj->ctx, dst.data, src.data, src.length);
+    info.GetReturnValue().Set((info[1]->IsUndefined()) ? info[0] : info[1]);
+  }
+}
+
+NAN_METHOD(Modulus::InverseBatch)
+{
+  Modulus *obj = This(info);
+  U64Column src, dst;
+  if ( (obj)&&(U64Column::FromArgument(info[0],src))&&(U64Column::DstArgument(info,1,src,dst)) ) {
+    mod_inverse_batch(&obj->ctx, dst.data, src.data, src.length);
+    info.GetReturnValue().Set((info[1]->IsUndefined()) ? info[0] : info[1]);
+  }
+}
+
+#define X(name,fn) \
+  NAN_METHOD(Modulus::name ## Batch)            \
+  {                                             \
+    Modulus *obj = This(info);                  \
+    U64Column src, dst;                         \
+    uint64_t scalar;                            \
+    const uint64_t *b;                          \
+    size_t step;                                \
+    if ( (obj)&&(U64Column::FromArgument(info[0],src))&&   \
+         (U64Column::OperandArgument(info[1],src.length,scalar,b,step))&& \
+         (U64Column::DstArgument(info,2,src,dst)) ) {      \
+      fn ## _batch(&obj->ctx, dst.data, src.data, b, step, src.length); \
+      info.GetReturnValue().Set((info[2]->IsUndefined()) ? info[0] : info[2]); \
+    }                                           \
+  }
+MODULUS_BINARY_OPS
+#undef X
+
+NAN_METHOD(Modulus::IsPrime)
+{
+  uint64_t n;
+  if (UInt64::FromArgument(info[0],n)) {
+    info.GetReturnValue().Set((bool)mod_isprime(n));
+  }
+}
+
+NAN_METHOD(Modulus::IsPrimeBatch)
+{
+  U64Column src;
+  if (!U64Column::FromArgument(info[0],src)) {
+    return;
+  }
+  const size_t outLen = (src.length + 7) / 8;
+
+  v8::Local<v8::Object> out;
+  if (info[1]->IsUndefined()) {
+    out = Nan::NewBuffer(outLen).ToLocalChecked();
+  } else if (!info[1]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as second argument");
+    return;
+  } else if (node::Buffer::Length(info[1]) < outLen) {
+    Nan::ThrowRangeError("Output buffer too small");
+    return;
+  } else {
+    out = info[1].As<v8::Object>();
+  }
+
+  mod_isprime_batch(src.data, src.length, (uint8_t *)node::Buffer::Data(out));
+  info.GetReturnValue().Set(out);
+}
@@ -0,0 +1,60 @@
+#ifndef _MODULUS_H
+#define _MODULUS_H
+
+#include <nan.h>
+#include "ext/modarith.h"
+
+/* Provides: modular arithmetic with precomputed constants (cf. ext/modarith.h)
+  values: Number, String, BigInt or UInt64; results are UInt64 in [0,m), written into out, if given
+
+new u64.Modulus(m)            - m >= 1; odd m: Montgomery, even m: Barrett
+.modulus:UInt64
+.montgomery:bool
+.reduce(a[,out])
+.addmod(a,b[,out]), .submod(a,b[,out]), .mulmod(a,b[,out]), .powmod(a,e[,out])
+.inverse(a[,out])             - RangeError, if gcd(a,m) != 1
+
+.reduceBatch(src[,dst]), .inverseBatch(src[,dst])   - inverseBatch: 0 where not invertible
+.addmodBatch(src,b[,dst]), .submodBatch, .mulmodBatch, .powmodBatch(src,e[,dst])
+* packed u64 columns (cf. column.h), dst defaults to src; b/e: column (elementwise) or single value
+
+u64.isPrime(n):bool          - deterministic for all 64bit n
+u64.isPrimeBatch(src[,out]):Buffer  - bitmask, bit (i&7) of out[i>>3] set iff src[i] is prime
+*/
+
+// name, mod_* function
+#define MODULUS_BINARY_OPS \
+  X(addmod, mod_add) \
+  X(submod, mod_sub) \
+  X(mulmod, mod_mul) \
+  X(powmod, mod_pow)
+
+class Modulus : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  Modulus(uint64_t m) { mod_init(&ctx, m); }
+
+  struct modctx ctx;
+
+  static Modulus *This(Nan::NAN_METHOD_ARGS_TYPE info);
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetModulus);
+  static NAN_GETTER(GetMontgomery);
+
+  static NAN_METHOD(Reduce);
+  static NAN_METHOD(Inverse);
+  static NAN_METHOD(ReduceBatch);
+  static NAN_METHOD(InverseBatch);
+#define X(name,fn) \
+  static NAN_METHOD(name); \
+  static NAN_METHOD(name ## Batch);
+  MODULUS_BINARY_OPS
+#undef X
+
+  static NAN_METHOD(IsPrime);
+  static NAN_METHOD(IsPrimeBatch);
+};
+
+#endif
@@ -0,0 +1,229 @@
+#include "recordschema.h"
+#include "addondata.h"
+#include "column.h"
+#include <string.h>
+
+NAN_MODULE_INIT(RecordSchema::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("RecordSchema").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->recordSchemaTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("stride").ToLocalChecked(), GetStride);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("length").ToLocalChecked(), GetLength);
+
+  Nan::SetPrototypeMethod(tpl, "decode", Decode);
+  Nan::SetPrototypeMethod(tpl, "encode", Encode);
+
+  Nan::Set(target, Nan::New("RecordSchema").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+RecordSchema *RecordSchema::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->recordSchemaTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad RecordSchema object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<RecordSchema>(info.Holder());
+}
+
+bool RecordSchema::FieldArgument(v8::Local<v8::Value> arg,size_t stride,struct recfield &ret)
+{
+  if (!arg->IsObject()) {
+    Nan::ThrowTypeError("Expected Object as field");
+    return false;
+  }
+  v8::Local<v8::Object> obj = arg.As<v8::Object>();
+  v8::Local<v8::Value> offset = Nan::Get(obj, Nan::New("offset").ToLocalChecked()).ToLocalChecked(),
+                       bits = Nan::Get(obj, Nan::New("bits").ToLocalChecked()).ToLocalChecked();
+  if ( (!offset->IsNumber())||( (!bits->IsUndefined())&&(!bits->IsNumber()) ) ) {
+    Nan::ThrowTypeError("Expected Numbers as field offset and bits");
+    return false;
+  }
+  const double off = offset->NumberValue(), width = bits->IsUndefined() ? 64 : bits->NumberValue();
+  if ( (width != 8)&&(width != 16)&&(width != 32)&&(width != 64) ) {
+    Nan::ThrowRangeError("Field bits must be 8, 16, 32 or 64");
+    return false;
+  } else if ( (!(off >= 0))||(off + width/8 > stride)||(off != (size_t)off) ) {
+    Nan::ThrowRangeError("Field must be inside the record");
+    return false;
+  }
+  ret.offset = (size_t)off;
+  ret.bytes = (unsigned int)width / 8;
+  ret.flags = (Nan::Get(obj, Nan::New("signed").ToLocalChecked()).ToLocalChecked()->BooleanValue() ? REC_SIGNED : 0) |
+              (Nan::Get(obj, Nan::New("bigEndian").ToLocalChecked()).ToLocalChecked()->BooleanValue() ? REC_BIGENDIAN : 0);
+  return true;
+}
+
+NAN_METHOD(RecordSchema::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("RecordSchema must be called with new");
+    return;
+  } else if ( (!info[0]->IsNumber())||(!info[1]->IsArray()) ) {
+    Nan::ThrowTypeError("Expected Number as stride and Array as fields");
+    return;
+  }
+  const double stride = info[0]->NumberValue();
+  if ( (!(stride >= 1))||(stride > 4294967295.0)||(stride != (size_t)stride) ) {
+    Nan::ThrowRangeError("Stride must be an integer between 1 and 2^32-1");
+    return;
+  }
+  v8::Local<v8::Array> arr = info[1].As<v8::Array>();
+  std::vector<struct recfield> fields(arr->Length());
+  for (size_t i=0; i<fields.size(); i++) {
+    if (!FieldArgument(Nan::Get(arr, i).ToLocalChecked(), (size_t)stride, fields[i])) {
+      return;
+    }
+  }
+
+  RecordSchema *obj = new RecordSchema((size_t)stride, fields);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(RecordSchema::GetStride)
+{
+  RecordSchema *obj = Nan::ObjectWrap::Unwrap<RecordSchema>(info.Holder());
+  info.GetReturnValue().Set((double)obj->stride);
+}
+
+NAN_GETTER(RecordSchema::GetLength)
+{
+  RecordSchema *obj = Nan::ObjectWrap::Unwrap<RecordSchema>(info.Holder());
+  info.GetReturnValue().Set((double)obj->fields.size());
+}
+
+// one column (or undefined: NULL) per field, each >= minLength; shortest: min. length of the given columns
+bool RecordSchema::ColumnsArgument(v8::Local<v8::Value> arg,std::vector<uint64_t *> &cols,size_t minLength,size_t *shortest) const
+{
+  if (!arg->IsArray()) {
+    Nan::ThrowTypeError("Expected Array of columns");
+    return false;
+  }
+  v8::Local<v8::Array> arr = arg.As<v8::Array>();
+  if (arr->Length() != fields.size()) {
+    Nan::ThrowRangeError("Expected one column per field");
+    return false;
+  }
+  cols.assign(fields.size(), (uint64_t *)0);
+  if (shortest) {
+    *shortest = (size_t)-1;
+  }
+  for (size_t i=0; i<fields.size(); i++) {
+    v8::Local<v8::Value> val = Nan::Get(arr, i).ToLocalChecked();
+    U64Column col;
+    if (val->IsUndefined()) {
+      continue;
+    } else if (!U64Column::FromArgument(val,col)) {
+      return false;
+    } else if (col.length < minLength) {
+      Nan::ThrowRangeError("Column too short");
+      return false;
+    }
+    cols[i] = col.data;
+    if ( (shortest)&&(col.length < *shortest) ) {
+      *shortest = col.length;
+    }
+  }
+  return true;
+}
+
+NAN_METHOD(RecordSchema::Decode)
+{
+  RecordSchema *obj = This(info);
+  if (!obj) {
+    return;
+  } else if (!info[0]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as records");
+    return;
+  } else if ( (!info[2]->IsUndefined())&&(!info[2]->IsNumber()) ) {
+    Nan::ThrowTypeError("Expected Number as outPos");
+    return;
+  }
+  const size_t n = node::Buffer::Length(info[0]) / obj->stride;
+  const double outPos = info[2]->IsUndefined() ? 0 : info[2]->NumberValue();
+  if ( (!(outPos >= 0))||(outPos > 9007199254740991.0)||(outPos != (size_t)outPos) ) {
+    Nan::ThrowRangeError("outPos must be a non-negative integer");
+    return;
+  }
+
+  v8::Local<v8::Value> ret = info[1];
+  const bool allocate = ret->IsUndefined();
+  if (allocate) {
+    if (outPos + n > U64Column::MaxNewBytes() / 8) {
+      Nan::ThrowRangeError("Columns would exceed the maximum Buffer length: pass cols or decode fewer records");
+      return;
+    }
+    v8::Local<v8::Array> arr = Nan::New<v8::Array>(obj->fields.size());
+    for (size_t i=0; i<obj->fields.size(); i++) {
+      Nan::Set(arr, i, Nan::NewBuffer((uint32_t)(((size_t)outPos + n) * 8)).ToLocalChecked());
+    }
+    ret = arr;
+  }
+  std::vector<uint64_t *> cols; // after all allocations and JS accesses (cf. column.h)
+  if (!obj->ColumnsArgument(ret, cols, (size_t)outPos + n, 0)) {
+    return;
+  }
+  for (size_t i=0; i<cols.size(); i++) {
+    if (cols[i]) {
+      if (allocate) { // new Buffers are uninitialized: do not expose [0,outPos)
+        memset(cols[i], 0, (size_t)outPos * 8);
+      }
+      cols[i] += (size_t)outPos;
+    }
+  }
+
+  rec_gather_all(cols.data(), (const uint8_t *)node::Buffer::Data(info[0]), obj->stride, n,
+                 obj->fields.data(), obj->fields.size());
+  info.GetReturnValue().Set(ret);
+}
+
+NAN_METHOD(RecordSchema::Encode)
+{
+  RecordSchema *obj = This(info);
+  std::vector<uint64_t *> cols;
+  size_t n;
+  if ( (!obj)||(!obj->ColumnsArgument(info[0], cols, 0, &n)) ) {
+    return;
+  } else if ( (!info[2]->IsUndefined())&&(!info[2]->IsNumber()) ) {
+    Nan::ThrowTypeError("Expected Number as count");
+    return;
+  }
+  if (!info[2]->IsUndefined()) {
+    const double count = info[2]->NumberValue();
+    if ( (!(count >= 0))||(count > n)||(count != (size_t)count) ) {
+      Nan::ThrowRangeError("Count must be an integer, at most the column length");
+      return;
+    }
+    n = (size_t)count;
+  } else if (n == (size_t)-1) {
+    n = 0; // no columns given
+  }
+
+  v8::Local<v8::Object> buf;
+  if (info[1]->IsUndefined()) {
+    if (n > U64Column::MaxNewBytes() / obj->stride) {
+      Nan::ThrowRangeError("Records would exceed the maximum Buffer length: pass buf or a smaller count");
+      return;
+    }
+    buf = Nan::NewBuffer((uint32_t)(n * obj->stride)).ToLocalChecked();
+    memset(node::Buffer::Data(buf), 0, n * obj->stride);
+    if (!obj->ColumnsArgument(info[0], cols, 0, 0)) { // allocation may have run the GC
+      return;
+    }
+  } else if (!info[1]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as records");
+    return;
+  } else if (node::Buffer::Length(info[1]) / obj->stride < n) {
+    Nan::ThrowRangeError("Records buffer too small");
+    return;
+  } else {
+    buf = info[1].As<v8::Object>();
+  }
+
+  rec_scatter_all((uint8_t *)node::Buffer::Data(buf), cols.data(), obj->stride, n,
+                  obj->fields.data(), obj->fields.size());
+  info.GetReturnValue().Set(buf);
+}
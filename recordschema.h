@@ -0,0 +1,43 @@
+#ifndef _RECORDSCHEMA_H
+#define _RECORDSCHEMA_H
+
+#include <nan.h>
+#include <vector>
+#include "ext/records.h"
+
+/* Provides: fixed-size binary records <-> one packed u64 column per field (cf. column.h, ext/records.h)
+
+new u64.RecordSchema(stride,fields)   - fields: Array of {offset, bits=64, signed=false, bigEndian=false}
+* bits: 8, 16, 32 or 64; offset+bits/8 <= stride; signed: narrow fields are sign-extended on decode
+.stride, .length (number of fields)
+
+.decode(buf[,cols[,outPos=0]]):cols  - buf: Buffer/TypedArray of floor(byteLength/stride) records
+* cols: Array with one column per field (undefined entry: field skipped), each >= outPos+records long;
+  allocated as Buffers (zero before outPos), if cols is undefined; RangeError beyond the max. Buffer length
+.encode(cols[,buf[,count]]):buf      - count defaults to the shortest column
+* buf: >= count*stride bytes, allocated (zero-filled) if undefined; undefined cols entries leave
+  their field unchanged
+*/
+
+class RecordSchema : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  RecordSchema(size_t stride,const std::vector<struct recfield> &fields) : stride(stride), fields(fields) {}
+
+  size_t stride;
+  std::vector<struct recfield> fields;
+
+  static RecordSchema *This(Nan::NAN_METHOD_ARGS_TYPE info);
+  static bool FieldArgument(v8::Local<v8::Value> arg,size_t stride,struct recfield &ret);
+  bool ColumnsArgument(v8::Local<v8::Value> arg,std::vector<uint64_t *> &cols,size_t minLength,size_t *shortest) const;
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetStride);
+  static NAN_GETTER(GetLength);
+
+  static NAN_METHOD(Decode);
+  static NAN_METHOD(Encode);
+};
+
+#endif
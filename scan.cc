@@ -0,0 +1,257 @@
+#include "scan.h"
+#include "uint64.h"
+#include "column.h"
+#include "ext/prefixsum.h"
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define SCAN_MIN_PER_THREAD (1<<16) // values; below that, thread startup dominates
+#define HIST_MAX_LOCAL (1<<16)      // buckets; larger histograms are counted single-threaded
+
+static std::atomic<unsigned int> maxThreads(0); // 0: number of cpus; shared by all worker threads
+
+static unsigned int Threads(size_t n)
+{
+  const unsigned int max = maxThreads.load(std::memory_order_relaxed),
+                     threads = max ? max : std::max(1u, std::thread::hardware_concurrency());
+  const size_t useful = std::max((size_t)1, n / SCAN_MIN_PER_THREAD);
+  return (useful < threads) ? (unsigned int)useful : threads;
+}
+
+// fn(t,begin,end) on `threads` consecutive blocks of [0,n); block 0 runs on the calling thread
+template <typename Fn>
+static void ParallelBlocks(size_t n,unsigned int threads,Fn fn)
+{
+  const size_t per = (n + threads-1) / threads;
+  std::vector<std::thread> pool;
+  for (unsigned int t=1; t<threads; t++) {
+    const size_t begin = std::min(n, t*per), end = std::min(n, begin+per);
+    pool.push_back(std::thread(fn, t, begin, end));
+  }
+  fn(0, 0, std::min(n, per));
+  for (size_t i=0; i<pool.size(); i++) {
+    pool[i].join();
+  }
+}
+
+static void Scan(Nan::NAN_METHOD_ARGS_TYPE info,bool exclusive)
+{
+  U64Column src, dst;
+  if ( (!U64Column::FromArgument(info[0],src))||(!U64Column::DstArgument(info,1,src,dst)) ) {
+    return;
+  }
+  const bool checked = info[2]->BooleanValue();
+  const size_t n = src.length;
+  const unsigned int threads = Threads(n);
+
+  uint64_t total = 0;
+  bool serial = (threads <= 1);
+  if (!serial) {
+    std::vector<uint64_t> sums(threads), carry(threads);
+    std::vector<char> overflow(threads);
+    ParallelBlocks(n, threads, [&](unsigned int t,size_t begin,size_t end) {
+      if (checked) {
+        uint64_t acc = 0;
+        overflow[t] = (scan_sum_checked(src.data + begin, end - begin, &acc) != end - begin);
+        sums[t] = acc;
+      } else {
+        sums[t] = scan_sum(src.data + begin, end - begin);
+      }
+    });
+    for (unsigned int t=0; t<threads; t++) {
+      carry[t] = total;
+      total += sums[t];
+      if ( (checked)&&((overflow[t])||(total < carry[t])) ) {
+        serial = true; // redo, to find the exact position
+      }
+    }
+    if (!serial) {
+      ParallelBlocks(n, threads, [&](unsigned int t,size_t begin,size_t end) {
+        if (exclusive) {
+          scan_exclusive(dst.data + begin, src.data + begin, end - begin, carry[t]);
+        } else {
+          scan_inclusive(dst.data + begin, src.data + begin, end - begin, carry[t]);
+        }
+      });
+    }
+  }
+  if (serial) {
+    if (checked) {
+      total = 0;
+      const size_t pos = exclusive ? scan_exclusive_checked(dst.data, src.data, n, &total)
+                                   : scan_inclusive_checked(dst.data, src.data, n, &total);
+      if (pos < n) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Scan overflows at index %lu", (unsigned long)pos);
+        Nan::ThrowRangeError(msg);
+        return;
+      }
+    } else {
+      total = exclusive ? scan_exclusive(dst.data, src.data, n, 0)
+                        : scan_inclusive(dst.data, src.data, n, 0);
+    }
+  }
+
+  if ( (exclusive)&&(dst.length > n) ) {
+    dst.data[n] = total;
+  }
+  info.GetReturnValue().Set((info[1]->IsUndefined()) ? info[0] : info[1]);
+}
+
+static NAN_METHOD(InclusiveScan)
+{
+  Scan(info, false);
+}
+
+static NAN_METHOD(ExclusiveScan)
+{
+  Scan(info, true);
+}
+
+static NAN_METHOD(SegmentedScan)
+{
+  U64Column src, dst;
+  if (!U64Column::FromArgument(info[0],src)) {
+    return;
+  } else if (!info[1]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as heads");
+    return;
+  } else if (node::Buffer::Length(info[1]) < (src.length + 7) / 8) {
+    Nan::ThrowRangeError("Heads bitmask too short");
+    return;
+  } else if (!U64Column::DstArgument(info,2,src,dst)) {
+    return;
+  }
+  const uint8_t *heads = (const uint8_t *)node::Buffer::Data(info[1]);
+  const int exclusive = info[3]->BooleanValue();
+  const size_t n = src.length;
+  const unsigned int threads = Threads(n);
+
+  if (threads <= 1) {
+    scan_segmented(dst.data, src.data, n, heads, 0, 0, exclusive);
+  } else {
+    std::vector<uint64_t> tails(threads), carry(threads);
+    std::vector<int> hasHead(threads);
+    ParallelBlocks(n, threads, [&](unsigned int t,size_t begin,size_t end) {
+      tails[t] = scan_segmented_tail(src.data + begin, end - begin, heads, begin, &hasHead[t]);
+    });
+    carry[0] = 0;
+    for (unsigned int t=1; t<threads; t++) {
+      carry[t] = hasHead[t-1] ? tails[t-1] : carry[t-1] + tails[t-1];
+    }
+    ParallelBlocks(n, threads, [&](unsigned int t,size_t begin,size_t end) {
+      scan_segmented(dst.data + begin, src.data + begin, end - begin, heads, begin, carry[t], exclusive);
+    });
+  }
+  info.GetReturnValue().Set((info[2]->IsUndefined()) ? info[0] : info[2]);
+}
+
+// count(counts,begin,end) per block; blocks other than 0 count into local arrays, summed afterwards
+template <typename Fn>
+static void ParallelHistogram(size_t n,uint64_t *counts,size_t buckets,Fn count)
+{
+  const unsigned int threads = (buckets <= HIST_MAX_LOCAL) ? Threads(n) : 1;
+  if (threads <= 1) {
+    count(counts, 0, n);
+    return;
+  }
+  std::vector<uint64_t> local((threads-1) * buckets, 0);
+  ParallelBlocks(n, threads, [&](unsigned int t,size_t begin,size_t end) {
+    count(t ? &local[(t-1) * buckets] : counts, begin, end);
+  });
+  for (unsigned int t=1; t<threads; t++) {
+    const uint64_t *part = &local[(t-1) * buckets];
+    for (size_t i=0; i<buckets; i++) {
+      counts[i] += part[i];
+    }
+  }
+}
+
+static NAN_METHOD(HistogramBits)
+{
+  U64Column src, counts;
+  if (!U64Column::FromArgument(info[0],src)) {
+    return;
+  } else if ( (!info[1]->IsNumber())||(!info[2]->IsNumber()) ) {
+    Nan::ThrowTypeError("Expected Numbers as shift and bits");
+    return;
+  }
+  const unsigned int shift = info[1]->Uint32Value(), bits = info[2]->Uint32Value();
+  if (shift > 63) {
+    Nan::ThrowRangeError("Shift must be between 0 and 63");
+    return;
+  } else if ( (bits < 1)||(bits > 24) ) {
+    Nan::ThrowRangeError("Bits must be between 1 and 24");
+    return;
+  } else if (!U64Column::FromArgument(info[3],counts)) {
+    return;
+  }
+  const size_t buckets = (size_t)1 << bits;
+  if (counts.length < buckets) {
+    Nan::ThrowRangeError("Counts column too short");
+    return;
+  }
+
+  const uint64_t *data = src.data;
+  ParallelHistogram(src.length, counts.data, buckets, [&](uint64_t *out,size_t begin,size_t end) {
+    hist_bits(out, data + begin, end - begin, shift, buckets - 1);
+  });
+  info.GetReturnValue().Set(info[3]);
+}
+
+static NAN_METHOD(HistogramBounds)
+{
+  U64Column src, bounds, counts;
+  if ( (!U64Column::FromArgument(info[0],src))||(!U64Column::FromArgument(info[1],bounds))||
+       (!U64Column::FromArgument(info[2],counts)) ) {
+    return;
+  }
+  for (size_t i=1; i<bounds.length; i++) {
+    if (bounds.data[i-1] > bounds.data[i]) {
+      Nan::ThrowRangeError("Bounds must be sorted ascending");
+      return;
+    }
+  }
+  const size_t buckets = bounds.length + 1;
+  if (counts.length < buckets) {
+    Nan::ThrowRangeError("Counts column too short");
+    return;
+  }
+
+  const uint64_t *data = src.data;
+  ParallelHistogram(src.length, counts.data, buckets, [&](uint64_t *out,size_t begin,size_t end) {
+    hist_bounds(out, data + begin, end - begin, bounds.data, bounds.length);
+  });
+  info.GetReturnValue().Set(info[2]);
+}
+
+static NAN_METHOD(Parallelism)
+{
+  if (!info[0]->IsUndefined()) {
+    if (!info[0]->IsNumber()) {
+      Nan::ThrowTypeError("Expected Number as argument");
+      return;
+    }
+    const double threads = info[0]->NumberValue();
+    if ( (!(threads >= 1))||(threads > 1024) ) {
+      Nan::ThrowRangeError("Threads must be between 1 and 1024");
+      return;
+    }
+    maxThreads.store((unsigned int)threads, std::memory_order_relaxed);
+  }
+  const unsigned int max = maxThreads.load(std::memory_order_relaxed);
+  info.GetReturnValue().Set(max ? max : std::max(1u, std::thread::hardware_concurrency()));
+}
+
+NAN_MODULE_INIT(InitScan)
+{
+  Nan::SetMethod(target, "inclusiveScan", InclusiveScan);
+  Nan::SetMethod(target, "exclusiveScan", ExclusiveScan);
+  Nan::SetMethod(target, "segmentedScan", SegmentedScan);
+  Nan::SetMethod(target, "histogramBits", HistogramBits);
+  Nan::SetMethod(target, "histogramBounds", HistogramBounds);
+  Nan::SetMethod(target, "parallelism", Parallelism);
+}
@@ -0,0 +1,25 @@
+#ifndef _SCAN_H
+#define _SCAN_H
+
+#include <nan.h>
+
+/* Provides: prefix sums and histograms on packed u64 columns (cf. column.h, ext/prefixsum.h)
+  large columns are processed by several threads (two passes: block sums, then blocks with carry-in)
+
+u64.inclusiveScan(src[,dst[,checked=false]]):dst    - dst defaults to src
+u64.exclusiveScan(src[,dst[,checked=false]]):dst    - dst[src.length] = total, if dst is longer
+* checked: RangeError on unsigned overflow (else wraps mod 2^64); dst is then partially written
+u64.segmentedScan(src,heads[,dst[,exclusive=false]]):dst
+* heads: bitmask (e.g. from hasBatch), bit (i&7) of heads[i>>3] set: segment starts at i
+
+u64.histogramBits(src,shift,bits,counts):counts      - counts[(v >> shift) & (2^bits-1)]++, bits 1..24
+u64.histogramBounds(src,bounds,counts):counts        - bounds: column, sorted ascending;
+* counts[k]++ for bounds[k-1] <= v < bounds[k]; counts needs bounds.length+1 entries
+* histograms add to counts (e.g. over several chunks); counts is a packed u64 column, too
+
+u64.parallelism([threads]):Number   - get/set max. threads (default: number of cpus; 1: single-threaded), process-wide
+*/
+
+NAN_MODULE_INIT(InitScan);
+
+#endif
@@ -0,0 +1,238 @@
+#include "selection.h"
+#include "uint64.h"
+#include "column.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define SELECT_HEAP_MAX_K 256 // and k <= n/16; beyond that, selecting on all pairs is faster
+
+static const uint64_t SIGN_BIT = (uint64_t)1 << 63;
+
+static bool SignedArgument(v8::Local<v8::Value> arg,v8::Local<v8::Value> col)
+{
+  if (arg->IsUndefined()) {
+#if NODE_MAJOR_VERSION >= 10
+    return col->IsBigInt64Array();
+#else
+    return false;
+#endif
+  }
+  return arg->BooleanValue();
+}
+
+// key: unsigned order of the requested ranking (flip: sign bit for signed, ~0 inverts for bottomK)
+struct Ranked {
+  uint64_t key;
+  size_t idx;
+};
+
+// a ranks before b: larger key, then lower index
+static inline bool Before(const Ranked &a,const Ranked &b)
+{
+  return (a.key > b.key)||( (a.key == b.key)&&(a.idx < b.idx) );
+}
+
+// ranks[0..k) best first
+static void SelectTop(std::vector<Ranked> &ranks,const uint64_t *data,size_t n,size_t k,uint64_t flip)
+{
+  if ( (k <= SELECT_HEAP_MAX_K)&&(k <= n/16) ) {
+    ranks.reserve(k); // heap with the worst kept entry on top
+    for (size_t i=0; i<n; i++) {
+      const Ranked r = { data[i] ^ flip, i };
+      if (ranks.size() < k) {
+        ranks.push_back(r);
+        std::push_heap(ranks.begin(), ranks.end(), Before);
+      } else if ( (k)&&(Before(r, ranks.front())) ) {
+        std::pop_heap(ranks.begin(), ranks.end(), Before);
+        ranks.back() = r;
+        std::push_heap(ranks.begin(), ranks.end(), Before);
+      }
+    }
+    std::sort_heap(ranks.begin(), ranks.end(), Before);
+    return;
+  }
+  ranks.resize(n);
+  for (size_t i=0; i<n; i++) {
+    ranks[i].key = data[i] ^ flip;
+    ranks[i].idx = i;
+  }
+  if (k < n) {
+    std::nth_element(ranks.begin(), ranks.begin() + k, ranks.end(), Before);
+  }
+  std::sort(ranks.begin(), ranks.begin() + k, Before);
+}
+
+// column of >= n entries at info[idx], or a new Buffer if undefined
+static bool OutArgument(v8::Local<v8::Value> arg,size_t n,v8::Local<v8::Object> &obj,U64Column &col)
+{
+  if (arg->IsUndefined()) {
+    obj = Nan::NewBuffer(n * 8).ToLocalChecked();
+  } else {
+    obj = arg.As<v8::Object>();
+  }
+  if (!U64Column::FromArgument(obj,col)) {
+    return false;
+  } else if (col.length < n) {
+    Nan::ThrowRangeError("Output column too short");
+    return false;
+  }
+  return true;
+}
+
+static void TopK(Nan::NAN_METHOD_ARGS_TYPE info,bool bottom)
+{
+  U64Column src;
+  if (!U64Column::FromArgument(info[0],src)) {
+    return;
+  } else if (!info[1]->IsNumber()) {
+    Nan::ThrowTypeError("Expected Number as k");
+    return;
+  }
+  const double kv = info[1]->NumberValue();
+  if ( (!(kv >= 0))||(kv > src.length)||(kv != floor(kv)) ) {
+    Nan::ThrowRangeError("k must be an integer between 0 and column length");
+    return;
+  }
+  const size_t k = (size_t)kv;
+  const bool asSigned = SignedArgument(info[2], info[0]);
+
+  v8::Local<v8::Object> indicesObj, valuesObj;
+  U64Column indices, values;
+  if ( (!OutArgument(info[3],k,indicesObj,indices))||(!OutArgument(info[4],k,valuesObj,values)) ) {
+    return;
+  }
+  // allocations may run the GC: take the data pointer again (cf. column.h)
+  U64Column::FromArgument(info[0],src);
+
+  const uint64_t flip = (asSigned ? SIGN_BIT : 0) ^ (bottom ? ~(uint64_t)0 : 0);
+  std::vector<Ranked> ranks;
+  SelectTop(ranks, src.data, src.length, k, flip);
+  for (size_t i=0; i<k; i++) {
+    indices.data[i] = ranks[i].idx;
+    values.data[i] = ranks[i].key ^ flip;
+  }
+
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+  Nan::Set(ret, Nan::New("indices").ToLocalChecked(), indicesObj);
+  Nan::Set(ret, Nan::New("values").ToLocalChecked(), valuesObj);
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(TopK)
+{
+  TopK(info, false);
+}
+
+static NAN_METHOD(BottomK)
+{
+  TopK(info, true);
+}
+
+struct FlippedLess {
+  uint64_t flip;
+  bool operator()(uint64_t a,uint64_t b) const { return (a ^ flip) < (b ^ flip); }
+};
+
+static NAN_METHOD(NthElement)
+{
+  U64Column col;
+  if (!U64Column::FromArgument(info[0],col)) {
+    return;
+  } else if (!info[1]->IsNumber()) {
+    Nan::ThrowTypeError("Expected Number as n");
+    return;
+  }
+  const double nv = info[1]->NumberValue();
+  if ( (!(nv >= 0))||(nv >= col.length)||(nv != floor(nv)) ) {
+    Nan::ThrowRangeError("n must be an integer below column length");
+    return;
+  }
+  const size_t n = (size_t)nv;
+  const bool asSigned = SignedArgument(info[2], info[0]);
+
+  const FlippedLess less = { asSigned ? SIGN_BIT : 0 };
+  std::nth_element(col.data, col.data + n, col.data + col.length, less);
+  info.GetReturnValue().Set(UInt64::NewInstance(col.data[n], asSigned));
+}
+
+static NAN_METHOD(Quantiles)
+{
+  std::vector<double> qs; // first: reading an Array may run JS
+  if (info[1]->IsArray()) {
+    v8::Local<v8::Array> arr = info[1].As<v8::Array>();
+    qs.resize(arr->Length());
+    for (size_t i=0; i<qs.size(); i++) {
+      qs[i] = Nan::To<double>(Nan::Get(arr, i).ToLocalChecked()).FromMaybe(NAN);
+    }
+  } else if (info[1]->IsFloat64Array()) {
+    const double *arr = (const double *)node::Buffer::Data(info[1]);
+    qs.assign(arr, arr + node::Buffer::Length(info[1]) / sizeof(double));
+  } else {
+    Nan::ThrowTypeError("Expected Array or Float64Array as quantiles");
+    return;
+  }
+  U64Column col;
+  if (!U64Column::FromArgument(info[0],col)) {
+    return;
+  }
+  const size_t n = col.length;
+  if ( (!n)&&(!qs.empty()) ) {
+    Nan::ThrowRangeError("Empty column");
+    return;
+  }
+  // (rank, position in qs), selected in ascending rank order
+  std::vector<std::pair<size_t,size_t> > ranks(qs.size());
+  for (size_t i=0; i<qs.size(); i++) {
+    if (!( (qs[i] >= 0)&&(qs[i] <= 1) )) {
+      Nan::ThrowRangeError("Quantiles must be between 0 and 1");
+      return;
+    }
+    const double rank = ceil(qs[i] * n);
+    ranks[i].first = (rank < 1) ? 0 : (size_t)rank - 1;
+    ranks[i].second = i;
+  }
+  const bool asSigned = SignedArgument(info[2], info[0]);
+
+  U64Column out;
+  if (!info[3]->IsUndefined()) {
+    if (!U64Column::FromArgument(info[3],out)) {
+      return;
+    } else if (out.length < qs.size()) {
+      Nan::ThrowRangeError("Output column too short");
+      return;
+    }
+  }
+  std::vector<uint64_t> result(qs.size());
+
+  std::sort(ranks.begin(), ranks.end());
+  const FlippedLess less = { asSigned ? SIGN_BIT : 0 };
+  size_t lo = 0, prev = n;
+  for (size_t i=0; i<ranks.size(); i++) {
+    const size_t r = ranks[i].first;
+    if (r != prev) { // everything below lo is <= col[lo] already
+      std::nth_element(col.data + lo, col.data + r, col.data + n, less);
+      lo = prev = r;
+    }
+    result[ranks[i].second] = col.data[r];
+  }
+
+  if (!info[3]->IsUndefined()) {
+    std::copy(result.begin(), result.end(), out.data);
+    info.GetReturnValue().Set(info[3]);
+    return;
+  }
+  v8::Local<v8::Array> ret = Nan::New<v8::Array>(result.size());
+  for (size_t i=0; i<result.size(); i++) {
+    Nan::Set(ret, i, UInt64::NewInstance(result[i], asSigned));
+  }
+  info.GetReturnValue().Set(ret);
+}
+
+NAN_MODULE_INIT(InitSelect)
+{
+  Nan::SetMethod(target, "topK", TopK);
+  Nan::SetMethod(target, "bottomK", BottomK);
+  Nan::SetMethod(target, "nthElement", NthElement);
+  Nan::SetMethod(target, "quantiles", Quantiles);
+}
@@ -0,0 +1,24 @@
+#ifndef _SELECTION_H
+#define _SELECTION_H
+
+#include <nan.h>
+
+/* Provides: selection on packed u64 columns (cf. column.h), expected linear time, no full sort
+  signed: compare as int64 (results Int64); undefined: true iff the column is a BigInt64Array
+
+u64.topK(col,k[,signed[,indices[,values]]]) -> {indices,values}
+u64.bottomK(col,k[,signed[,indices[,values]]]) -> {indices,values}
+* the k largest/smallest values, best first (ties: lower index first); col is not modified
+* indices, values: columns of >= k entries, allocated if undefined
+* small k: bounded heap, O(n log k); else introselect (std::nth_element) on (value,index) pairs
+
+u64.nthElement(col,n[,signed]):UInt64  - value of rank n (0: smallest)
+u64.quantiles(col,qs[,signed[,out]]):out  - qs: Array/Float64Array of fractions in [0,1]
+* value of rank ceil(q*length) (1-based), as Histogram.percentile(100*q); out: column, or Array of UInt64
+* both reorder col in place, like std::nth_element (pass col.slice() to keep the original);
+  quantiles selects the sorted ranks one after another, each in the remaining upper part
+*/
+
+NAN_MODULE_INIT(InitSelect);
+
+#endif
@@ -0,0 +1,157 @@
+// v8 serializer support (Node >= 8): UInt64/Int64 (and Histogram) survive serialization as real instances,
+// and columns (any ArrayBufferView) can be moved instead of copied.
+//
+// new u64.Serializer(), new u64.Deserializer(buffer) - v8.DefaultSerializer/DefaultDeserializer + host objects
+//
+// u64.encodeMessage(value[,transferList]):msg  - e.g. port.postMessage(msg, msg.buffers)
+//   transferList: ArrayBuffers to move (like postMessage's); views on them arrive as views on the moved buffer,
+//                 other views are copied (8 byte aligned on arrival); not for mapped columns (cf. mapFile)
+//   msg: {buffers:[ArrayBuffer...]} - buffers[0] holds the serialized data
+// u64.decodeMessage(msg):value
+//
+// * postMessage() itself offers no hook for addon objects, hence the explicit encode/decode step
+
+var v8=require('v8');
+var u64=require('./build/Release/u64.node');
+var UInt64=u64.UInt64,
+    Int64=u64.Int64;
+
+var TAG_DEFAULT=0, TAG_UINT64=1, TAG_INT64=2, TAG_VIEW=3, TAG_VIEW_MOVED=4, TAG_HISTOGRAM=5;
+
+var viewTypes=['Buffer','DataView','Int8Array','Uint8Array','Uint8ClampedArray','Int16Array','Uint16Array',
+               'Int32Array','Uint32Array','Float32Array','Float64Array','BigInt64Array','BigUint64Array'];
+
+function viewType(view) {
+  if (Buffer.isBuffer(view)) {
+    return 0;
+  }
+  var name=Object.prototype.toString.call(view).slice(8,-1);
+  return viewTypes.indexOf(name);
+}
+
+function newView(type,buffer,byteOffset,byteLength) {
+  if (type===0) {
+    return Buffer.from(buffer,byteOffset,byteLength);
+  }
+  var ctor=global[viewTypes[type]];
+  if (!ctor) {
+    throw new TypeError('Unsupported view type: '+viewTypes[type]);
+  }
+  return new ctor(buffer,byteOffset,byteLength/(ctor.BYTES_PER_ELEMENT || 1));
+}
+
+class Serializer extends v8.DefaultSerializer {
+  constructor() {
+    super();
+    this._transfer=[];
+  }
+
+  // like v8.Serializer#transferArrayBuffer, but also applies to views on ab
+  transferArrayBuffer(id,ab) {
+    this._transfer[id]=ab;
+    super.transferArrayBuffer(id,ab);
+  }
+
+  _writeHostObject(obj) {
+    if (obj instanceof UInt64) {
+      this.writeUint32((obj instanceof Int64) ? TAG_INT64 : TAG_UINT64);
+      this.writeUint64(obj.hi32,obj.lo32);
+    } else if (obj instanceof u64.Histogram) {
+      var data=obj.serialize();
+      this.writeUint32(TAG_HISTOGRAM);
+      this.writeUint32(data.length);
+      this.writeRawBytes(data);
+    } else if (ArrayBuffer.isView(obj) && viewType(obj)>=0) {
+      var id=this._transfer.indexOf(obj.buffer);
+      this.writeUint32((id>=0) ? TAG_VIEW_MOVED : TAG_VIEW);
+      this.writeUint32(viewType(obj));
+      if (id>=0) {
+        this.writeUint32(id);
+        this.writeDouble(obj.byteOffset);
+        this.writeDouble(obj.byteLength);
+      } else {
+        this.writeDouble(obj.byteLength);
+        this.writeRawBytes(new Uint8Array(obj.buffer,obj.byteOffset,obj.byteLength));
+      }
+    } else {
+      this.writeUint32(TAG_DEFAULT);
+      super._writeHostObject(obj);
+    }
+  }
+}
+
+class Deserializer extends v8.DefaultDeserializer {
+  constructor(buffer) {
+    super(buffer);
+    this._transfer=[];
+  }
+
+  transferArrayBuffer(id,ab) {
+    this._transfer[id]=ab;
+    super.transferArrayBuffer(id,ab);
+  }
+
+  _readHostObject() {
+    var tag=this.readUint32(), type;
+    switch (tag) {
+    case TAG_UINT64:
+    case TAG_INT64:
+      var hilo=this.readUint64();
+      return (tag===TAG_INT64) ? new Int64(hilo[0]|0,hilo[1]) : new UInt64(hilo[0],hilo[1]);
+    case TAG_HISTOGRAM:
+      return u64.Histogram.deserialize(this.readRawBytes(this.readUint32()));
+    case TAG_VIEW_MOVED:
+      type=this.readUint32();
+      var ab=this._transfer[this.readUint32()];
+      if (!ab) {
+        throw new Error('Missing transferred ArrayBuffer');
+      }
+      return newView(type,ab,this.readDouble(),this.readDouble());
+    case TAG_VIEW:
+      type=this.readUint32();
+      var byteLength=this.readDouble(), bytes=this.readRawBytes(byteLength);
+      // own, aligned memory: usable as packed u64 column, independent of the message buffer
+      var copy=Buffer.allocUnsafeSlow(byteLength);
+      bytes.copy(copy);
+      return newView(type,copy.buffer,copy.byteOffset,byteLength);
+    case TAG_DEFAULT:
+      return super._readHostObject();
+    default:
+      throw new Error('Unknown host object tag: '+tag);
+    }
+  }
+}
+
+function encodeMessage(value,transferList) {
+  var ser=new Serializer(), buffers=[null];
+  (transferList || []).forEach(function(ab) {
+    ser.transferArrayBuffer(buffers.length,ab);
+    buffers.push(ab);
+  });
+  ser.writeHeader();
+  ser.writeValue(value);
+  var data=ser.releaseBuffer();
+  if (data.byteOffset!==0 || data.byteLength!==data.buffer.byteLength) {
+    var own=Buffer.allocUnsafeSlow(data.length); // own ArrayBuffer, so it can be transferred
+    data.copy(own);
+    data=own;
+  }
+  buffers[0]=data.buffer;
+  return {buffers:buffers};
+}
+
+function decodeMessage(msg) {
+  var des=new Deserializer(Buffer.from(msg.buffers[0]));
+  for (var i=1; i<msg.buffers.length; i++) {
+    des.transferArrayBuffer(i,msg.buffers[i]);
+  }
+  des.readHeader();
+  return des.readValue();
+}
+
+module.exports={
+  Serializer: Serializer,
+  Deserializer: Deserializer,
+  encodeMessage: encodeMessage,
+  decodeMessage: decodeMessage
+};
@@ -0,0 +1,78 @@
+#include "stats.h"
+
+#ifdef U64_STATS
+#include <string.h>
+
+u64_stat u64_stats[U64S_COUNT];
+uint64_t u64_stats_args[U64S_ARG_COUNT];
+uint32_t u64_stats_period = 0;
+
+static const char *const statNames[U64S_COUNT] = {
+#define X(name,code) #name,
+  UINT64_UNARY_OPS
+  UINT64_BINARY_OPS
+  UINT64_UINT_OPS
+#undef X
+#define X(name,copyName,code) #copyName, "UInt64." #name,
+  UINT64_UNARY_COPY_OPS
+  UINT64_BINARY_COPY_OPS
+  UINT64_UINT_COPY_OPS
+#undef X
+  "new", "NewInstance", "toString", "FromArgument"
+};
+
+static const char *const argNames[U64S_ARG_COUNT] = {
+  "Number", "String", "UInt64", "BigInt", "invalid"
+};
+
+#endif
+
+static NAN_METHOD(Stats)
+{
+  v8::Local<v8::Object> ret = Nan::New<v8::Object>();
+#ifdef U64_STATS
+  ret->Set(Nan::New("enabled").ToLocalChecked(),Nan::New(true));
+  ret->Set(Nan::New("samplePeriod").ToLocalChecked(),Nan::New(u64_stats_period));
+
+  v8::Local<v8::Object> ops = Nan::New<v8::Object>();
+  for (int i=0; i<U64S_COUNT; i++) {
+    if (!u64_stats[i].calls) {
+      continue;
+    }
+    v8::Local<v8::Object> op = Nan::New<v8::Object>();
+    op->Set(Nan::New("calls").ToLocalChecked(),Nan::New((double)u64_stats[i].calls));
+    op->Set(Nan::New("sampled").ToLocalChecked(),Nan::New((double)u64_stats[i].sampled));
+    op->Set(Nan::New("ns").ToLocalChecked(),Nan::New((double)u64_stats[i].ns));
+    ops->Set(Nan::New(statNames[i]).ToLocalChecked(),op);
+  }
+  ret->Set(Nan::New("ops").ToLocalChecked(),ops);
+
+  v8::Local<v8::Object> args = Nan::New<v8::Object>();
+  for (int i=0; i<U64S_ARG_COUNT; i++) {
+    args->Set(Nan::New(argNames[i]).ToLocalChecked(),Nan::New((double)u64_stats_args[i]));
+  }
+  ret->Set(Nan::New("args").ToLocalChecked(),args);
+#else
+  ret->Set(Nan::New("enabled").ToLocalChecked(),Nan::New(false));
+#endif
+  info.GetReturnValue().Set(ret);
+}
+
+static NAN_METHOD(ResetStats)
+{
+  if ( (!info[0]->IsUndefined())&&(!info[0]->IsNumber()) ) {
+    Nan::ThrowTypeError("Expected Number as argument");
+    return;
+  }
+#ifdef U64_STATS
+  memset(u64_stats, 0, sizeof(u64_stats));
+  memset(u64_stats_args, 0, sizeof(u64_stats_args));
+  u64_stats_period = info[0]->Uint32Value();
+#endif
+}
+
+NAN_MODULE_INIT(InitStats)
+{
+  Nan::SetMethod(target, "stats", Stats);
+  Nan::SetMethod(target, "resetStats", ResetStats);
+}
@@ -0,0 +1,82 @@
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <nan.h>
+#include "uint64.h"
+
+/* Provides: opt-in instrumentation of the UInt64 entry points
+  build with  node-gyp rebuild --u64_stats=1  (binding.gyp variable, defines U64_STATS);
+  otherwise U64_STATS_OP / U64_STATS_ARG expand to nothing
+
+u64.stats() -> {enabled:bool, samplePeriod, ops:{name:{calls,sampled,ns}}, args:{Number,String,UInt64,BigInt,invalid}}
+* ops: only those called at least once; names: op / copyName, "UInt64.name" for the statics,
+  "new", "NewInstance" (internal allocations), "toString", "FromArgument"
+* ns: total time of the sampled calls (every samplePeriod-th call of each op), ns/sampled is the mean
+u64.resetStats([samplePeriod])
+* samplePeriod: 0 (default) disables timing
+
+* counters are not atomic: numbers from several worker threads are approximate
+*/
+
+enum u64_stat_id {
+#define X(name,code) U64S_op_ ## name,
+  UINT64_UNARY_OPS
+  UINT64_BINARY_OPS
+  UINT64_UINT_OPS
+#undef X
+#define X(name,copyName,code) U64S_copy_ ## copyName, U64S_static_ ## name,
+  UINT64_UNARY_COPY_OPS
+  UINT64_BINARY_COPY_OPS
+  UINT64_UINT_COPY_OPS
+#undef X
+  U64S_New, U64S_NewInstance, U64S_ToString, U64S_FromArgument,
+  U64S_COUNT
+};
+
+enum u64_stat_arg {
+  U64S_ARG_Number, U64S_ARG_String, U64S_ARG_UInt64, U64S_ARG_BigInt, U64S_ARG_invalid,
+  U64S_ARG_COUNT
+};
+
+#ifdef U64_STATS
+
+struct u64_stat {
+  uint64_t calls, sampled, ns;
+};
+
+extern u64_stat u64_stats[U64S_COUNT];
+extern uint64_t u64_stats_args[U64S_ARG_COUNT];
+extern uint32_t u64_stats_period;
+
+class U64StatsScope {
+public:
+  explicit U64StatsScope(u64_stat_id id) : stat(u64_stats[id]), start(Begin(stat)) {}
+  ~U64StatsScope() {
+    if (start) {
+      stat.ns += uv_hrtime() - start;
+      stat.sampled++;
+    }
+  }
+private:
+  static uint64_t Begin(u64_stat &stat) {
+    ++stat.calls;
+    return (u64_stats_period && stat.calls % u64_stats_period == 0) ? uv_hrtime() : 0;
+  }
+
+  u64_stat &stat;
+  const uint64_t start;
+};
+
+#define U64_STATS_OP(id) U64StatsScope _u64_stats_scope(id)
+#define U64_STATS_ARG(type) (void)++u64_stats_args[type]
+
+#else
+
+#define U64_STATS_OP(id)
+#define U64_STATS_ARG(type)
+
+#endif
+
+NAN_MODULE_INIT(InitStats);
+
+#endif
@@ -0,0 +1,81 @@
+// u64.ParseStream([options]): Transform, delimited u64 text -> packed u64 column chunks
+//   options: signed (false), delimiters (',;' - whitespace always delimits), cf. TextParser in textparser.h
+//            chunkSize (65536): values per emitted chunk
+//            poolSize (4): released chunks kept for reuse; also the readable highWaterMark
+// emits Buffers (8 byte aligned) of chunkSize*8 bytes, only the last one may be shorter;
+//   e.g. new BigUint64Array(chunk.buffer, chunk.byteOffset, chunk.length/8), or any *Batch function
+// stream.release(chunk): hand a chunk back after use, so parsing does not allocate
+
+var Transform=require('stream').Transform,
+    util=require('util');
+var u64=require('./build/Release/u64.node');
+
+function ParseStream(options) {
+  if (!(this instanceof ParseStream)) {
+    return new ParseStream(options);
+  }
+  options=options || {};
+  this._chunkSize=options.chunkSize || 65536;
+  this._poolSize=(options.poolSize!==undefined) ? options.poolSize : 4;
+  Transform.call(this,{readableObjectMode:true, readableHighWaterMark:this._poolSize || 1});
+
+  this._parser=new u64.TextParser(!!options.signed,options.delimiters);
+  this._pool=[];
+  this._out=null;
+  this._outPos=0;
+}
+util.inherits(ParseStream,Transform);
+
+ParseStream.prototype._acquire=function() {
+  return this._pool.pop() || Buffer.allocUnsafeSlow(this._chunkSize*8);
+};
+
+ParseStream.prototype.release=function(chunk) {
+  if ( (chunk.length===this._chunkSize*8)&&(this._pool.length<this._poolSize)&&
+       (this._pool.indexOf(chunk)<0)&&(chunk!==this._out) ) {
+    this._pool.push(chunk);
+  }
+};
+
+ParseStream.prototype._transform=function(chunk,encoding,callback) {
+  if (typeof chunk==='string') {
+    chunk=Buffer.from(chunk,encoding);
+  }
+  var parser=this._parser, start=0;
+  try {
+    while (start<chunk.length) {
+      if (!this._out) {
+        this._out=this._acquire();
+        this._outPos=0;
+      }
+      this._outPos=parser.parse(chunk,start,this._out,this._outPos);
+      start=parser.offset;
+      if (this._outPos===this._chunkSize) {
+        this.push(this._out);
+        this._out=null;
+      }
+    }
+  } catch (e) {
+    return callback(e);
+  }
+  callback();
+};
+
+ParseStream.prototype._flush=function(callback) {
+  if (!this._out) {
+    this._out=this._acquire();
+    this._outPos=0;
+  }
+  try {
+    this._outPos=this._parser.finish(this._out,this._outPos);
+  } catch (e) {
+    return callback(e);
+  }
+  if (this._outPos>0) {
+    this.push(this._out.slice(0,this._outPos*8));
+  }
+  this._out=null;
+  callback();
+};
+
+module.exports=ParseStream;
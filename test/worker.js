@@ -0,0 +1,59 @@
+// main <-> worker_threads round trip: the addon loads in a Worker after the main thread,
+// and encodeMessage/decodeMessage restore UInt64/Int64, Histograms and columns on either side.
+// usage: node --experimental-worker test/worker.js   (flag only needed for node 10)
+
+var assert=require('assert');
+var worker;
+try {
+  worker=require('worker_threads');
+} catch (e) {
+  console.log('skipped: no worker_threads');
+  process.exit(0);
+}
+var u64=require('..');
+
+if (worker.isMainThread) {
+  var col=new Float64Array(4);
+  u64.inclusiveScan(col); // loads into this isolate first
+  var msg=u64.encodeMessage({
+    a: new u64.UInt64('0xffffffffffffffff'),
+    b: new u64.Int64(-5),
+    col: Buffer.from(new Uint8Array([1,0,0,0,0,0,0,0, 2,0,0,0,0,0,0,0])),
+    moved: col
+  },[col.buffer]);
+
+  var w=new worker.Worker(__filename);
+  w.on('error',function(err) {
+    console.error(err);
+    process.exit(1);
+  });
+  w.on('message',function(reply) {
+    var v=u64.decodeMessage(reply);
+    assert.ok(v.a instanceof u64.UInt64 && !(v.a instanceof u64.Int64));
+    assert.strictEqual(v.a.toString(),'18446744073709551614');
+    assert.ok(v.b instanceof u64.Int64);
+    assert.strictEqual(v.b.toString(),'-4');
+    assert.ok(v.hist instanceof u64.Histogram);
+    assert.strictEqual(v.hist.totalCount,1);
+    assert.strictEqual(v.hist.max.toString(),'18446744073709551614');
+    assert.deepStrictEqual(Array.from(new Uint8Array(v.col.buffer,v.col.byteOffset,v.col.byteLength)),
+                           [1,0,0,0,0,0,0,0, 3,0,0,0,0,0,0,0]);
+    w.terminate();
+    console.log('ok');
+  });
+  w.postMessage(msg,msg.buffers);
+} else {
+  worker.parentPort.on('message',function(msg) {
+    var v=u64.decodeMessage(msg);
+    assert.ok(v.a instanceof u64.UInt64);
+    assert.ok(v.b instanceof u64.Int64);
+    assert.strictEqual(v.moved.length,4);
+    v.a.sub(1);
+    v.b.add(1);
+    u64.inclusiveScan(v.col); // still a usable packed u64 column
+    var hist=new u64.Histogram();
+    hist.record(v.a);
+    var reply=u64.encodeMessage({a:v.a, b:v.b, col:v.col, hist:hist});
+    worker.parentPort.postMessage(reply,reply.buffers);
+  });
+}
@@ -0,0 +1,229 @@
+#include "textparser.h"
+#include "addondata.h"
+#include "u64str.h"
+#include "column.h"
+#include <string.h>
+#include <stdio.h>
+
+NAN_MODULE_INIT(TextParser::Init)
+{
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(New);
+  tpl->SetClassName(Nan::New("TextParser").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  AddonData::Get()->textParserTmpl.Reset(tpl);
+
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("offset").ToLocalChecked(), GetOffset);
+  Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("position").ToLocalChecked(), GetPosition);
+
+  Nan::SetPrototypeMethod(tpl, "parse", Parse);
+  Nan::SetPrototypeMethod(tpl, "finish", Finish);
+
+  Nan::Set(target, Nan::New("TextParser").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
+}
+
+TextParser::TextParser(bool withSign,const char *delimiters)
+  : withSign(withSign), partialLen(0), offset(0), position(0)
+{
+  memset(delim, 0, sizeof(delim));
+  static const char whitespace[] = " \t\r\n\v\f";
+  for (const char *s=whitespace; *s; s++) {
+    delim[(unsigned char)*s] = true;
+  }
+  for (const char *s=delimiters; *s; s++) {
+    delim[(unsigned char)*s] = true;
+  }
+}
+
+TextParser *TextParser::This(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (!Nan::New(AddonData::Get()->textParserTmpl)->HasInstance(info.Holder())) {
+    Nan::ThrowTypeError("Bad TextParser object");
+    return 0;
+  }
+  return Nan::ObjectWrap::Unwrap<TextParser>(info.Holder());
+}
+
+NAN_METHOD(TextParser::New)
+{
+  if (!info.IsConstructCall()) {
+    Nan::ThrowTypeError("TextParser must be called with new");
+    return;
+  }
+  if ( (!info[1]->IsUndefined())&&(!info[1]->IsString()) ) {
+    Nan::ThrowTypeError("Expected String as second argument");
+    return;
+  }
+  Nan::Utf8String delimiters(info[1]->IsUndefined() ? Nan::New(",;").ToLocalChecked() : info[1].As<v8::String>());
+  for (const char *s=*delimiters; *s; s++) {
+    const char c = *s|0x20; // lowercase
+    if ( ((*s>='0')&&(*s<='9'))||((c>='a')&&(c<='z'))||(*s=='+')||(*s=='-')||(*s&0x80) ) {
+      Nan::ThrowRangeError("Delimiters must be ASCII and must not contain digits, letters, + or -");
+      return;
+    }
+  }
+
+  TextParser *obj = new TextParser(info[0]->BooleanValue(), *delimiters);
+  obj->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_GETTER(TextParser::GetOffset)
+{
+  TextParser *obj = Nan::ObjectWrap::Unwrap<TextParser>(info.Holder());
+  info.GetReturnValue().Set((double)obj->offset);
+}
+
+NAN_GETTER(TextParser::GetPosition)
+{
+  TextParser *obj = Nan::ObjectWrap::Unwrap<TextParser>(info.Holder());
+  info.GetReturnValue().Set(obj->position);
+}
+
+TextParser::Result TextParser::Token(const char *s,const char *end,uint64_t &ret) const
+{
+  if (end-s > TEXTPARSER_MAX_TOKEN) {
+    return INVALID;
+  }
+  switch (u64ParseString(s, end, withSign, &ret)) {
+  case U64STR_OK:
+    return OK;
+  case U64STR_RANGE:
+    return RANGE;
+  default:
+    return INVALID;
+  }
+}
+
+void TextParser::ThrowToken(Result res,const char *s,const char *end,double pos) const
+{
+  char msg[128];
+  const int len = (end-s > 32) ? 32 : (int)(end-s);
+  snprintf(msg, sizeof(msg), "%s '%.*s%s' at byte %.0f",
+           (res == RANGE) ? "Number out of range" : "Invalid number",
+           len, s, (end-s > len) ? "..." : "", pos);
+  if (res == RANGE) {
+    Nan::ThrowRangeError(msg);
+  } else {
+    Nan::ThrowError(msg);
+  }
+}
+
+// out,outPos from info[idx],info[idx+1]; requires room for at least one value
+bool TextParser::OutArguments(Nan::NAN_METHOD_ARGS_TYPE info,int idx,uint64_t *&out,size_t &outLen,size_t &outPos)
+{
+  U64Column col;
+  if (!U64Column::FromArgument(info[idx],col)) {
+    return false;
+  } else if (!info[idx+1]->IsNumber()) {
+    Nan::ThrowTypeError("Expected Number as output position");
+    return false;
+  }
+  const double pos = info[idx+1]->NumberValue();
+  if ( (!(pos >= 0))||(pos >= (double)col.length) ) {
+    Nan::ThrowRangeError("Output position must be less than the column length");
+    return false;
+  }
+  out = col.data;
+  outLen = col.length;
+  outPos = (size_t)pos;
+  return true;
+}
+
+NAN_METHOD(TextParser::Parse)
+{
+  TextParser *obj = This(info);
+  if (!obj) {
+    return;
+  } else if (!info[0]->IsArrayBufferView()) {
+    Nan::ThrowTypeError("Expected Buffer or TypedArray as first argument");
+    return;
+  }
+  const char *base = node::Buffer::Data(info[0]);
+  const size_t len = node::Buffer::Length(info[0]);
+  const double start = info[1]->NumberValue();
+  if ( (!(start >= 0))||(start > (double)len) ) {
+    Nan::ThrowRangeError("Start must be between 0 and chunk length");
+    return;
+  }
+  uint64_t *out;
+  size_t outLen, n;
+  if (!OutArguments(info, 2, out, outLen, n)) {
+    return;
+  }
+
+  const bool *delim = obj->delim;
+  const char *p = base + (size_t)start, *end = base + len;
+  const double position = obj->position - (p - base); // of base
+
+  if (obj->partialLen) { // continue token from previous chunk
+    while ( (p<end)&&(!delim[(unsigned char)*p]) ) {
+      if (obj->partialLen == TEXTPARSER_MAX_TOKEN) {
+        obj->ThrowToken(INVALID, obj->partial, obj->partial + obj->partialLen, position + (p - base) - obj->partialLen);
+        return;
+      }
+      obj->partial[obj->partialLen++] = *p++;
+    }
+    if (p<end) {
+      const Result res = obj->Token(obj->partial, obj->partial + obj->partialLen, out[n]);
+      if (res != OK) {
+        obj->ThrowToken(res, obj->partial, obj->partial + obj->partialLen, position + (p - base) - obj->partialLen);
+        return;
+      }
+      n++;
+      obj->partialLen = 0;
+    }
+  }
+
+  while (n<outLen) {
+    while ( (p<end)&&(delim[(unsigned char)*p]) ) {
+      p++;
+    }
+    if (p==end) {
+      break;
+    }
+    const char *tok = p;
+    while ( (p<end)&&(!delim[(unsigned char)*p]) ) {
+      p++;
+    }
+    if (p==end) { // maybe incomplete: keep
+      if (p-tok > TEXTPARSER_MAX_TOKEN) {
+        obj->ThrowToken(INVALID, tok, p, position + (tok - base));
+        return;
+      }
+      memcpy(obj->partial, tok, p-tok);
+      obj->partialLen = p-tok;
+      break;
+    }
+    const Result res = obj->Token(tok, p, out[n]);
+    if (res != OK) {
+      obj->ThrowToken(res, tok, p, position + (tok - base));
+      return;
+    }
+    n++;
+  }
+
+  obj->offset = p - base;
+  obj->position = position + obj->offset;
+  info.GetReturnValue().Set((double)n);
+}
+
+NAN_METHOD(TextParser::Finish)
+{
+  TextParser *obj = This(info);
+  uint64_t *out;
+  size_t outLen, n;
+  if ( (!obj)||(!OutArguments(info, 0, out, outLen, n)) ) {
+    return;
+  }
+  if (obj->partialLen) {
+    const Result res = obj->Token(obj->partial, obj->partial + obj->partialLen, out[n]);
+    if (res != OK) {
+      obj->ThrowToken(res, obj->partial, obj->partial + obj->partialLen, obj->position - obj->partialLen);
+      return;
+    }
+    n++;
+    obj->partialLen = 0;
+  }
+  obj->offset = 0;
+  info.GetReturnValue().Set((double)n);
+}
@@ -0,0 +1,52 @@
+#ifndef _TEXTPARSER_H
+#define _TEXTPARSER_H
+
+#include <nan.h>
+
+/* Provides: incremental parser for delimited u64 text (e.g. one id per line), cf. stream.js
+
+new u64.TextParser([signed=false[,delimiters=',;']])  - whitespace always delimits
+* tokens: [+]digits, with signed also -digits (stored as two's complement), cf. u64ParseString:
+  decimal, 0x hex, 0b binary or 0o octal digits, '_' between digits
+* out of range (> 2^64-1, or < -2^63), malformed and overlong (> 64 bytes) tokens throw;
+  the message contains the byte position
+
+.parse(chunk,start,out,outPos):outPos  - chunk: Buffer/TypedArray, out: packed u64 column (cf. column.h)
+* parses chunk[start..] into out[outPos..], until chunk is consumed or out is full; returns the new outPos
+* a token at the end of chunk is kept until its delimiter (or finish()) arrives
+.offset                 - where the last parse() stopped in its chunk (== chunk.length: all consumed)
+.finish(out,outPos):outPos  - end of input: emits the pending token, if any; the parser can then be reused
+.position               - total bytes consumed
+*/
+
+#define TEXTPARSER_MAX_TOKEN 64
+
+class TextParser : public Nan::ObjectWrap {
+public:
+  static NAN_MODULE_INIT(Init);
+private:
+  TextParser(bool withSign,const char *delimiters);
+
+  bool withSign;
+  bool delim[256];
+  char partial[TEXTPARSER_MAX_TOKEN]; // token spanning chunk boundaries
+  size_t partialLen;
+  size_t offset;
+  double position;
+
+  enum Result { OK, INVALID, RANGE };
+  Result Token(const char *s,const char *end,uint64_t &ret) const;
+  void ThrowToken(Result res,const char *s,const char *end,double pos) const;
+
+  static TextParser *This(Nan::NAN_METHOD_ARGS_TYPE info);
+  static bool OutArguments(Nan::NAN_METHOD_ARGS_TYPE info,int idx,uint64_t *&out,size_t &outLen,size_t &outPos);
+
+  static NAN_METHOD(New);
+  static NAN_GETTER(GetOffset);
+  static NAN_GETTER(GetPosition);
+
+  static NAN_METHOD(Parse);
+  static NAN_METHOD(Finish);
+};
+
+#endif
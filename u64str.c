@@ -1,4 +1,5 @@
 #include "u64str.h"
+#include <string.h>
 
 static char hexDigit(char c)
 {
@@ -46,6 +47,189 @@ uint64_t u64FromString(const char *s,const char *end)
   return ret;
 }
 
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define U64STR_SWAR  // eight decimal digits per step, cf. parse8Digits
+#endif
+
+#ifdef U64STR_SWAR
+// all eight bytes in '0'..'9': high nibble 3, and still 3 after adding 6
+static int isEightDigits(uint64_t val)
+{
+  return (((val&0xf0f0f0f0f0f0f0f0)|(((val+0x0606060606060606)&0xf0f0f0f0f0f0f0f0)>>4))==0x3333333333333333);
+}
+
+// first char in the low byte; combines digit pairs, then pairs of pairs, then the two halves
+static uint64_t parseEightDigits(uint64_t val)
+{
+  val-=0x3030303030303030;
+  val=(val*10)+(val>>8);
+  return (((val&0x000000ff000000ff)*(100+(1000000ULL<<32)))+
+          (((val>>16)&0x000000ff000000ff)*(1+(10000ULL<<32))))>>32;
+}
+#endif
+
+// digit value+1 (0: no digit), for all radixes up to 16
+static const unsigned char digitValues[256]={
+  ['0']=1, ['1']=2, ['2']=3, ['3']=4, ['4']=5, ['5']=6, ['6']=7, ['7']=8, ['8']=9, ['9']=10,
+  ['A']=11, ['B']=12, ['C']=13, ['D']=14, ['E']=15, ['F']=16,
+  ['a']=11, ['b']=12, ['c']=13, ['d']=14, ['e']=15, ['f']=16
+};
+
+// '_' only between two digits; after a run of digits, s is at '_' (or the bad char)
+static int isSeparator(const char *s,const char *begin,const char *end,unsigned int radix)
+{
+  return (*s=='_')&&(s!=begin)&&(s+1!=end)&&((unsigned int)(digitValues[(unsigned char)s[1]]-1)<radix);
+}
+
+// valid digits (and '_'), but too many for the fast paths to rule out overflow: check exactly
+static int overflows(const char *s,const char *end,int shift)
+{
+  static const char maxDecimal[]="18446744073709551615";
+  while ( (s!=end)&&((*s=='0')||(*s=='_')) ) {
+    s++;
+  }
+  size_t n=0;
+  for (const char *p=s; p!=end; p++) {
+    n+=(*p!='_');
+  }
+  if (!shift) {
+    if (n!=20) {
+      return n>20;
+    }
+    for (const char *m=maxDecimal; s!=end; s++) {
+      if (*s=='_') {
+        continue;
+      } else if (*s!=*m) {
+        return *s>*m;
+      }
+      m++;
+    }
+    return 0;
+  }
+  if (!n) {
+    return 0;
+  }
+  size_t bits=(n-1)*shift;
+  for (unsigned int first=digitValues[(unsigned char)*s]-1; first; first>>=1) {
+    bits++;
+  }
+  return bits>64;
+}
+
+// wraps; the caller checks for overflow, only when there are more than 19 digits
+static int parseDecimal(const char *s,const char *end,uint64_t *ret)
+{
+  const char *begin=s;
+  uint64_t val=0;
+  size_t separators=0;
+  if (s==end) {
+    return U64STR_INVALID;
+  }
+  for (;;) {
+#ifdef U64STR_SWAR
+    while (end-s>=8) {
+      uint64_t chunk;
+      memcpy(&chunk,s,8);
+      if (!isEightDigits(chunk)) {
+        break;
+      }
+      val=val*100000000+parseEightDigits(chunk);
+      s+=8;
+    }
+#endif
+    for (; s!=end; s++) {
+      const unsigned int res=(unsigned char)*s-'0';
+      if (res>9) {
+        break;
+      }
+      val=val*10+res;
+    }
+    if (s==end) {
+      break;
+    } else if (!isSeparator(s,begin,end,10)) {
+      return U64STR_INVALID;
+    }
+    separators++;
+    s++;
+  }
+  if ((size_t)(end-begin)-separators>19) {
+    const int range=( (!separators)&&(end-begin==20)&&(*begin!='0') ) ? (memcmp(begin,"18446744073709551615",20)>0)
+                                                                        : overflows(begin,end,0);
+    if (range) {
+      return U64STR_RANGE;
+    }
+  }
+  *ret=val;
+  return U64STR_OK;
+}
+
+// radix 2^shift
+static int parsePow2(const char *s,const char *end,int shift,uint64_t *ret)
+{
+  const char *begin=s;
+  const unsigned int radix=1<<shift;
+  uint64_t val=0;
+  size_t separators=0;
+  if (s==end) {
+    return U64STR_INVALID;
+  }
+  for (;;) {
+    for (; s!=end; s++) {
+      const unsigned int res=digitValues[(unsigned char)*s]-1;
+      if (res>=radix) {
+        break;
+      }
+      val=(val<<shift)|res;
+    }
+    if (s==end) {
+      break;
+    } else if (!isSeparator(s,begin,end,radix)) {
+      return U64STR_INVALID;
+    }
+    separators++;
+    s++;
+  }
+  if ( (((size_t)(end-begin)-separators)*shift>64)&&(overflows(begin,end,shift)) ) {
+    return U64STR_RANGE;
+  }
+  *ret=val;
+  return U64STR_OK;
+}
+
+int u64ParseString(const char *s,const char *end,int withSign,uint64_t *ret)
+{
+  int neg=0;
+  if ( (withSign)&&(s!=end)&&(*s=='-') ) {
+    neg=1;
+    s++;
+  } else if ( (s!=end)&&(*s=='+') ) {
+    s++;
+  }
+
+  uint64_t val;
+  int res;
+  if ( (end-s>=2)&&(s[0]=='0')&&((s[1]|0x20)=='x') ) {
+    res=parsePow2(s+2,end,4,&val);
+  } else if ( (end-s>=2)&&(s[0]=='0')&&((s[1]|0x20)=='b') ) {
+    res=parsePow2(s+2,end,1,&val);
+  } else if ( (end-s>=2)&&(s[0]=='0')&&((s[1]|0x20)=='o') ) {
+    res=parsePow2(s+2,end,3,&val);
+  } else {
+    res=parseDecimal(s,end,&val);
+  }
+  if (res!=U64STR_OK) {
+    return res;
+  }
+  if (neg) {
+    if (val>((uint64_t)1<<63)) {
+      return U64STR_RANGE;
+    }
+    val=-val;
+  }
+  *ret=val;
+  return U64STR_OK;
+}
+
 // returns NULL on bad radix or missing scratch, else pointer to result
 // scratch space must be at least 65 bytes
 char *u64ToString(uint64_t val,int radix,char *scratch65)
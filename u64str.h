@@ -7,8 +7,16 @@
 extern "C" {
 #endif
 
+// lenient: stops at the first bad character, wraps on overflow
 uint64_t u64FromString(const char *s,const char *end);
 
+enum { U64STR_OK, U64STR_INVALID, U64STR_RANGE };
+
+// strict: the whole of [s,end) must be [+]digits, with withSign also -digits (two's complement, >= -2^63);
+// digits: decimal, 0x/0X hex, 0b/0B binary or 0o/0O octal, '_' allowed between two digits;
+// *ret is set only for U64STR_OK
+int u64ParseString(const char *s,const char *end,int withSign,uint64_t *ret);
+
 // returns NULL on bad radix or missing scratch, else pointer to result
 // scratch space must be at least 65 bytes
 char *u64ToString(uint64_t val,int radix,char *scratch65);
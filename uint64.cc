@@ -1,21 +1,22 @@
 #include "uint64.h"
+#include "addondata.h"
 #include "u64str.h"
-#include "ext/bitcount.h"
+#include "kernels.h"
+#include "stats.h"
+#include "ext/bitops.h"
 #include "ext/shifts.h"
 #include "ext/adc_sbb.h"
 
-Nan::Persistent<v8::Function> UInt64::constructor;
-Nan::Persistent<v8::Function> UInt64::constructorSigned;
-Nan::Persistent<v8::FunctionTemplate> UInt64::tmpl;
-
 NAN_MODULE_INIT(UInt64::Init)
 {
+  AddonData *data = AddonData::Get();
   v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(UInt64::NewUInt64);
   tpl->SetClassName(Nan::New("UInt64").ToLocalChecked());
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
-  tmpl.Reset(tpl);
+  data->uint64Tmpl.Reset(tpl);
 
   Nan::SetMethod(tpl, "Compare", Compare);
+  Nan::SetMethod(tpl, "tryParse", TryParse);
 
   Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("sign").ToLocalChecked(), GetSign, SetSign);
   Nan::SetAccessor(tpl->InstanceTemplate(),Nan::New("hi32").ToLocalChecked(), GetHi32, SetHi32);
@@ -29,7 +30,15 @@ NAN_MODULE_INIT(UInt64::Init)
   UINT64_UINT_OPS
 #undef X
 
-  constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
+#define X(name,copyName,code) \
+  Nan::SetPrototypeMethod(tpl, #copyName, copy_ ## copyName); \
+  Nan::SetMethod(tpl, #name, static_ ## name);
+  UINT64_UNARY_COPY_OPS
+  UINT64_BINARY_COPY_OPS
+  UINT64_UINT_COPY_OPS
+#undef X
+
+  data->uint64Constructor.Reset(Nan::GetFunction(tpl).ToLocalChecked());
   Nan::Set(target, Nan::New("UInt64").ToLocalChecked(), Nan::GetFunction(tpl).ToLocalChecked());
 
   // proper Int64 derivation can only be done on the native side...
@@ -37,32 +46,33 @@ NAN_MODULE_INIT(UInt64::Init)
   tpl2->SetClassName(Nan::New("Int64").ToLocalChecked());
   tpl2->Inherit(tpl);
   tpl2->InstanceTemplate()->SetInternalFieldCount(1);
+  data->int64Tmpl.Reset(tpl2);
 
   Nan::SetMethod(tpl2, "Compare", SignedCompare);
+  Nan::SetMethod(tpl2, "tryParse", SignedTryParse);
+
+#define X(name,copyName,code) Nan::SetMethod(tpl2, #name, static_ ## name);
+  UINT64_UNARY_COPY_OPS
+  UINT64_BINARY_COPY_OPS
+  UINT64_UINT_COPY_OPS
+#undef X
 
-  constructorSigned.Reset(Nan::GetFunction(tpl2).ToLocalChecked());
+  data->int64Constructor.Reset(Nan::GetFunction(tpl2).ToLocalChecked());
   Nan::Set(target, Nan::New("Int64").ToLocalChecked(), Nan::GetFunction(tpl2).ToLocalChecked());
 }
 
-static uint64_t u64FromString(v8::Local<v8::String> value,bool withSign)
+// strict, cf. u64ParseString; returns U64STR_*
+static int ParseString(v8::Local<v8::String> value,bool withSign,uint64_t &ret)
 {
-  Nan::Utf8String str(value);
-  const char *s=*str,
-             *end=s+str.length();
-
-  // TODO? skip whitespace?
-  if ( (withSign)&&(*s=='-') ) {
-    return -u64FromString(s+1,end);
-  } else if (*s=='+') {
-    s++;
-  }
-  return u64FromString(s,end);
+  return UInt64::ParseBytes(value, [&](const char *s,const char *end) {
+    return u64ParseString(s, end, withSign, &ret);
+  });
 }
 
 bool UInt64::HasInstance(v8::Local<v8::Value> value)
 {
   // alternative: store <v8::Value> GetPrototype() and compare
-  return Nan::New(tmpl)->HasInstance(value);
+  return Nan::New(AddonData::Get()->uint64Tmpl)->HasInstance(value);
 }
 
 uint64_t UInt64::Value(v8::Local<v8::Value> value)
@@ -70,6 +80,11 @@ uint64_t UInt64::Value(v8::Local<v8::Value> value)
   return Unwrap(value->ToObject())->value;
 }
 
+void UInt64::SetValue(v8::Local<v8::Value> obj,uint64_t value)
+{
+  Unwrap(obj->ToObject())->value = value;
+}
+
 UInt64 *UInt64::This(Nan::NAN_METHOD_ARGS_TYPE info)
 {
   if (!HasInstance(info.Holder())) {
@@ -79,30 +94,96 @@ UInt64 *UInt64::This(Nan::NAN_METHOD_ARGS_TYPE info)
   return Unwrap(info.Holder());
 }
 
+bool UInt64::IsSigned(v8::Local<v8::Value> value)
+{
+  return Nan::New(AddonData::Get()->int64Tmpl)->HasInstance(value);
+}
+
+// UInt64.op(a,...) / Int64.op(a,...): result type follows a, or the constructor it was called on
+bool UInt64::StaticSigned(Nan::NAN_METHOD_ARGS_TYPE info)
+{
+  if (HasInstance(info[0])) {
+    return IsSigned(info[0]);
+  }
+  return info.This()->StrictEquals(Nan::New(AddonData::Get()->int64Constructor));
+}
+
+// into info[outIdx], if given, else into new instance
+void UInt64::SetResult(Nan::NAN_METHOD_ARGS_TYPE info,int outIdx,uint64_t value,bool asSigned)
+{
+  v8::Local<v8::Value> out = info[outIdx];
+  if (out->IsUndefined()) {
+    info.GetReturnValue().Set(NewInstance(value,asSigned));
+  } else if (HasInstance(out)) {
+    Unwrap(out.As<v8::Object>())->value = value;
+    info.GetReturnValue().Set(out);
+  } else {
+    Nan::ThrowTypeError("Expected UInt64 as destination");
+  }
+}
+
+// start, len of a bit field at info[idx], info[idx+1]: integers 0..64
+bool UInt64::BitRangeArguments(Nan::NAN_METHOD_ARGS_TYPE info,int idx,unsigned int &start,unsigned int &len)
+{
+  if ( (!info[idx]->IsNumber())||(!info[idx+1]->IsNumber()) ) {
+    Nan::ThrowTypeError("Expected Numbers as start and len");
+    return false;
+  }
+  const double s = info[idx]->NumberValue(), l = info[idx+1]->NumberValue();
+  if ( (!(s >= 0))||(s > 64)||(s != (unsigned int)s)||(!(l >= 0))||(l > 64)||(l != (unsigned int)l) ) {
+    Nan::ThrowRangeError("start and len must be integers between 0 and 64");
+    return false;
+  }
+  start = (unsigned int)s;
+  len = (unsigned int)l;
+  return true;
+}
+
 // TODO?  Maybe<uint64_t> / optional
 bool UInt64::FromArgument(v8::Local<v8::Value> arg,uint64_t &ret,bool withSign)
 {
+  U64_STATS_OP(U64S_FromArgument);
   if (arg->IsNumber()) {
+    U64_STATS_ARG(U64S_ARG_Number);
     ret = (uint64_t)arg->NumberValue(); // TODO? better?
     return true;
   } else if (arg->IsString()) {
-    ret = u64FromString(arg->ToString(),withSign);
-    return true;
+    U64_STATS_ARG(U64S_ARG_String);
+    switch (ParseString(arg.As<v8::String>(),withSign,ret)) {
+    case U64STR_OK:
+      return true;
+    case U64STR_RANGE:
+      Nan::ThrowRangeError(withSign ? "Number string out of range (-2^63 .. 2^64-1)" : "Number string out of range (0 .. 2^64-1)");
+      return false;
+    default:
+      Nan::ThrowError("Invalid number string");
+      return false;
+    }
   } else if (HasInstance(arg)) {
+    U64_STATS_ARG(U64S_ARG_UInt64);
     ret = Value(arg);
     return true;
+#if NODE_MAJOR_VERSION >= 10
+  } else if (arg->IsBigInt()) {
+    U64_STATS_ARG(U64S_ARG_BigInt);
+    ret = arg.As<v8::BigInt>()->Uint64Value(); // wraps, like Number and String
+    return true;
+#endif
   }
-  Nan::ThrowTypeError("Argument must be Number, String or UInt64");
+  U64_STATS_ARG(U64S_ARG_invalid);
+  Nan::ThrowTypeError("Argument must be Number, String, BigInt or UInt64");
   return false;
 }
 
 v8::Local<v8::Object> UInt64::NewInstance(uint64_t value,bool asSigned)
 {
+  U64_STATS_OP(U64S_NewInstance);
   Nan::EscapableHandleScope scope;
 
   // TODO? could empty v8::Local<> be enough? [or is it converted to undefined?]
-  v8::Local<v8::Value> arg = Nan::New<v8::External>(&constructor); // magic token
-  v8::Local<v8::Function> cons = Nan::New(asSigned ? constructorSigned : constructor);
+  AddonData *data = AddonData::Get();
+  v8::Local<v8::Value> arg = Nan::New<v8::External>(&data->uint64Constructor); // magic token
+  v8::Local<v8::Function> cons = Nan::New(asSigned ? data->int64Constructor : data->uint64Constructor);
   v8::Local<v8::Object> instance = cons->NewInstance(1, &arg);
 
   UInt64 *obj = new UInt64(value);
@@ -114,7 +195,7 @@ v8::Local<v8::Object> UInt64::NewInstance(uint64_t value,bool asSigned)
 void UInt64::New(Nan::NAN_METHOD_ARGS_TYPE info,bool asSigned)
 {
   if ( (info.IsConstructCall())&&(info.Length()==1)&&(info[0]->IsExternal()) ) {
-    if (info[0].As<v8::External>()->Value() == &constructor) { // magic token: internal invocation
+    if (info[0].As<v8::External>()->Value() == &AddonData::Get()->uint64Constructor) { // magic token: internal invocation
       // caller will add missing internal UInt64 *
       info.GetReturnValue().Set(info.This());
     } else {
@@ -122,6 +203,7 @@ void UInt64::New(Nan::NAN_METHOD_ARGS_TYPE info,bool asSigned)
     }
     return;
   }
+  U64_STATS_OP(U64S_New);
 
   // process arguments
   uint64_t value;
@@ -189,7 +271,7 @@ NAN_METHOD(UInt64::Compare)
 NAN_METHOD(UInt64::SignedCompare)
 {
   uint64_t a,b;
-  if ( (FromArgument(info[0],a))&&(FromArgument(info[1],b)) ) {
+  if ( (FromArgument(info[0],a,true))&&(FromArgument(info[1],b,true)) ) {
     if ((int64_t)a < (int64_t)b) {
       RET(-1);
     } else if ((int64_t)a > (int64_t)b) {
@@ -200,6 +282,26 @@ NAN_METHOD(UInt64::SignedCompare)
   }
 }
 
+// like new UInt64(str), but null instead of an exception for anything but a valid String
+static void TryParse(Nan::NAN_METHOD_ARGS_TYPE info,bool asSigned)
+{
+  uint64_t value;
+  if ( (info[0]->IsString())&&(ParseString(info[0].As<v8::String>(),asSigned,value) == U64STR_OK) ) {
+    RET(UInt64::NewInstance(value,asSigned));
+  }
+  RET(Nan::Null());
+}
+
+NAN_METHOD(UInt64::TryParse)
+{
+  ::TryParse(info,false);
+}
+
+NAN_METHOD(UInt64::SignedTryParse)
+{
+  ::TryParse(info,true);
+}
+
 NAN_GETTER(UInt64::GetSign)
 {
   UInt64 *obj = Unwrap(info.Holder()); // or: This(info);
@@ -242,6 +344,7 @@ NAN_SETTER(UInt64::SetLo32)
 
 NAN_METHOD(UInt64::ToString)
 {
+  U64_STATS_OP(U64S_ToString);
   UInt64 *obj = This(info);
   if (!obj) {
     return;
@@ -265,6 +368,7 @@ NAN_METHOD(UInt64::ToString)
 #define X(name,code) \
   NAN_METHOD(UInt64::op_ ## name)             \
   {                                           \
+    U64_STATS_OP(U64S_op_ ## name);           \
     if (UInt64 *obj = This(info)) {           \
       uint64_t &lhs = obj->value;             \
       code;                                   \
@@ -277,9 +381,10 @@ UINT64_UNARY_OPS
 #define X(name,code) \
   NAN_METHOD(UInt64::op_ ## name)               \
   {                                             \
+    U64_STATS_OP(U64S_op_ ## name);             \
     if (UInt64 *obj = This(info)) {             \
       uint64_t &lhs = obj->value, rhs;          \
-      if (FromArgument(info[0],rhs)) {          \
+      if (FromArgument(info[0],rhs,IsSigned(info.Holder()))) { \
         code;                                   \
         info.GetReturnValue().Set(info.This()); \
       }                                         \
@@ -291,6 +396,7 @@ UINT64_BINARY_OPS
 #define X(name,code) \
   NAN_METHOD(UInt64::op_ ## name)               \
   {                                             \
+    U64_STATS_OP(U64S_op_ ## name);             \
     if (!info[0]->IsNumber()) {                 \
       Nan::ThrowTypeError("Expected Number as argument"); \
       return;                                   \
@@ -305,3 +411,84 @@ UINT64_BINARY_OPS
 UINT64_UINT_OPS
 #undef X
 
+#define X(name,copyName,code) \
+  NAN_METHOD(UInt64::copy_ ## copyName)       \
+  {                                           \
+    U64_STATS_OP(U64S_copy_ ## copyName);     \
+    if (UInt64 *obj = This(info)) {           \
+      uint64_t lhs = obj->value;              \
+      code;                                   \
+      SetResult(info, 0, lhs, IsSigned(info.Holder())); \
+    }                                         \
+  }                                           \
+  NAN_METHOD(UInt64::static_ ## name)         \
+  {                                           \
+    U64_STATS_OP(U64S_static_ ## name);       \
+    const bool asSigned = StaticSigned(info); \
+    uint64_t lhs;                             \
+    if (FromArgument(info[0],lhs,asSigned)) { \
+      code;                                   \
+      SetResult(info, 1, lhs, asSigned);      \
+    }                                         \
+  }
+UINT64_UNARY_COPY_OPS
+#undef X
+
+#define X(name,copyName,code) \
+  NAN_METHOD(UInt64::copy_ ## copyName)         \
+  {                                             \
+    U64_STATS_OP(U64S_copy_ ## copyName);       \
+    if (UInt64 *obj = This(info)) {             \
+      uint64_t lhs = obj->value, rhs;           \
+      if (FromArgument(info[0],rhs,IsSigned(info.Holder()))) { \
+        code;                                   \
+        SetResult(info, 1, lhs, IsSigned(info.Holder())); \
+      }                                         \
+    }                                           \
+  }                                             \
+  NAN_METHOD(UInt64::static_ ## name)           \
+  {                                             \
+    U64_STATS_OP(U64S_static_ ## name);         \
+    const bool asSigned = StaticSigned(info);   \
+    uint64_t lhs, rhs;                          \
+    if ( (FromArgument(info[0],lhs,asSigned))&&(FromArgument(info[1],rhs,asSigned)) ) { \
+      code;                                     \
+      SetResult(info, 2, lhs, asSigned);        \
+    }                                           \
+  }
+UINT64_BINARY_COPY_OPS
+#undef X
+
+#define X(name,copyName,code) \
+  NAN_METHOD(UInt64::copy_ ## copyName)         \
+  {                                             \
+    U64_STATS_OP(U64S_copy_ ## copyName);       \
+    if (!info[0]->IsNumber()) {                 \
+      Nan::ThrowTypeError("Expected Number as argument"); \
+      return;                                   \
+    }                                           \
+    const uint32_t rhs = info[0]->Uint32Value();\
+    if (UInt64 *obj = This(info)) {             \
+      uint64_t lhs = obj->value;                \
+      code;                                     \
+      SetResult(info, 1, lhs, IsSigned(info.Holder())); \
+    }                                           \
+  }                                             \
+  NAN_METHOD(UInt64::static_ ## name)           \
+  {                                             \
+    U64_STATS_OP(U64S_static_ ## name);         \
+    if (!info[1]->IsNumber()) {                 \
+      Nan::ThrowTypeError("Expected Number as second argument"); \
+      return;                                   \
+    }                                           \
+    const bool asSigned = StaticSigned(info);   \
+    const uint32_t rhs = info[1]->Uint32Value();\
+    uint64_t lhs;                               \
+    if (FromArgument(info[0],lhs,asSigned)) {   \
+      code;                                     \
+      SetResult(info, 2, lhs, asSigned);        \
+    }                                           \
+  }
+UINT64_UINT_COPY_OPS
+#undef X
+
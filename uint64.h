@@ -8,8 +8,15 @@
   X(not,    { lhs = ~lhs; }) \
   X(abs,    { if (lhs>>63) lhs = -lhs; }) \
                              \
-  X(clz,    RET(clz64(lhs))) \
-  X(ctz,    RET(ctz64(lhs))) \
+  X(clz,    RET(u64k->clz64(lhs))) \
+  X(ctz,    RET(u64k->ctz64(lhs))) \
+  X(popcnt, RET(u64k->popcnt64(lhs))) \
+  X(parity, RET(u64k->parity64(lhs))) \
+                             \
+  X(bswap,      { lhs = bswap64(lhs); }) \
+  X(bitReverse, { lhs = bitreverse64(lhs); }) \
+  X(blsr,       { lhs = blsr64(lhs); }) \
+  X(blsi,       { lhs = blsi64(lhs); }) \
                              \
   X(isZero, RET(lhs == 0))
 
@@ -24,6 +31,10 @@
   X(or,  { lhs |= rhs; })    \
   X(xor, { lhs ^= rhs; })    \
                              \
+  X(pdep, { lhs = u64k->pdep64(lhs, rhs); }) \
+  X(pext, { lhs = u64k->pext64(lhs, rhs); }) \
+  X(insertBits, { unsigned int start; unsigned int len; if (!BitRangeArguments(info,1,start,len)) return; lhs = insertbits64(lhs, rhs, start, len); }) \
+                             \
   X(eq,  RET(lhs == rhs))    \
   X(lt,  RET(lhs < rhs))     \
   X(gt,  RET(lhs > rhs))     \
@@ -35,7 +46,32 @@
   X(shr, { lhs = shr64(lhs, rhs); }) \
   X(sar, { lhs = sar64(lhs, rhs); }) \
   X(rol, { lhs = rol64(lhs, rhs); }) \
-  X(ror, { lhs = ror64(lhs, rhs); })
+  X(ror, { lhs = ror64(lhs, rhs); }) \
+  X(extractBits, { unsigned int start; unsigned int len; if (!BitRangeArguments(info,0,start,len)) return; lhs = extractbits64(lhs, rhs, len); })
+
+// non-mutating forms (name, copyName, code):
+//   a.copyName(...[,out]) and UInt64.name(a,...[,out]) write the result into out, if given,
+//   else into a new object of the same type as a
+#define UINT64_UNARY_COPY_OPS \
+  X(neg, negate,    { lhs = -lhs; }) \
+  X(not, bitNot,    { lhs = ~lhs; }) \
+  X(abs, magnitude, { if (lhs>>63) lhs = -lhs; })
+
+#define UINT64_BINARY_COPY_OPS \
+  X(add, plus,   { lhs += rhs; }) \
+  X(sub, minus,  { lhs -= rhs; }) \
+  X(and, bitAnd, { lhs &= rhs; }) \
+  X(or,  bitOr,  { lhs |= rhs; }) \
+  X(xor, bitXor, { lhs ^= rhs; })
+
+#define UINT64_UINT_COPY_OPS \
+  X(shl, bitShl, { lhs = shl64(lhs, rhs); }) \
+  X(shr, bitShr, { lhs = shr64(lhs, rhs); }) \
+  X(sar, bitSar, { lhs = sar64(lhs, rhs); }) \
+  X(rol, bitRol, { lhs = rol64(lhs, rhs); }) \
+  X(ror, bitRor, { lhs = ror64(lhs, rhs); })
+
+#define U64_MAX_STRING 160 // one-byte strings up to that length are parsed from the stack
 
 class UInt64 : public Nan::ObjectWrap {
   static inline UInt64 *Unwrap(v8::Local<v8::Object> obj) {
@@ -49,20 +85,44 @@ public:
 
   static bool HasInstance(v8::Local<v8::Value> value);
   static uint64_t Value(v8::Local<v8::Value> value);
+  static void SetValue(v8::Local<v8::Value> obj,uint64_t value);
   static v8::Local<v8::Object> NewInstance(uint64_t value,bool asSigned=false);
+  static bool FromArgument(v8::Local<v8::Value> arg,uint64_t &ret,bool withSign=false);
+  static void SetResult(Nan::NAN_METHOD_ARGS_TYPE info,int outIdx,uint64_t value,bool asSigned);
+  static bool BitRangeArguments(Nan::NAN_METHOD_ARGS_TYPE info,int idx,unsigned int &start,unsigned int &len);
+
+  // returns parse(begin,end) over the bytes of value
+  template <typename Fn>
+  static int ParseBytes(v8::Local<v8::String> value,Fn parse) {
+    const int len = value->Length();
+    if ( (len <= U64_MAX_STRING)&&(value->IsOneByte()) ) { // Latin-1 bytes as they are: no heap copy, no UTF-8 conversion
+      char buf[U64_MAX_STRING];
+#if NODE_MAJOR_VERSION >= 12
+      value->WriteOneByte(v8::Isolate::GetCurrent(), (uint8_t *)buf, 0, len, v8::String::NO_NULL_TERMINATION);
+#else
+      value->WriteOneByte((uint8_t *)buf, 0, len, v8::String::NO_NULL_TERMINATION);
+#endif
+      return parse((const char *)buf, (const char *)buf+len);
+    }
+    Nan::Utf8String str(value); // long (leading zeros, '_') or two-byte representation
+    return parse((const char *)*str, (const char *)*str+str.length());
+  }
 
   static NAN_MODULE_INIT(Init);
 private:
   uint64_t value;
 
   static UInt64 *This(Nan::NAN_METHOD_ARGS_TYPE info);
-  static bool FromArgument(v8::Local<v8::Value> arg,uint64_t &ret,bool withSign=false);
+  static bool IsSigned(v8::Local<v8::Value> value);
+  static bool StaticSigned(Nan::NAN_METHOD_ARGS_TYPE info);
 
   static void New(Nan::NAN_METHOD_ARGS_TYPE info,bool asSigned);
   static NAN_METHOD(NewUInt64);
   static NAN_METHOD(NewInt64);
   static NAN_METHOD(Compare);
   static NAN_METHOD(SignedCompare);
+  static NAN_METHOD(TryParse);
+  static NAN_METHOD(SignedTryParse);
 
   static NAN_GETTER(GetSign);
   static NAN_SETTER(SetSign);
@@ -79,9 +139,13 @@ private:
   UINT64_UINT_OPS
 #undef X
 
-  static Nan::Persistent<v8::Function> constructor;
-  static Nan::Persistent<v8::Function> constructorSigned;
-  static Nan::Persistent<v8::FunctionTemplate> tmpl;
+#define X(name,copyName,code) \
+  static NAN_METHOD(copy_ ## copyName); \
+  static NAN_METHOD(static_ ## name);
+  UINT64_UNARY_COPY_OPS
+  UINT64_BINARY_COPY_OPS
+  UINT64_UINT_COPY_OPS
+#undef X
 };
 
 #endif